@@ -1,7 +1,11 @@
 #include "Appetizer.hpp"
+#include "DietaryMemo.hpp"
+#include <algorithm>
 #include <string>
 #include <vector>
 
+const char* const Appetizer::SERVING_STYLE_NAMES[BUFFET + 1] = { "PLATED", "FAMILY_STYLE", "BUFFET" };
+
 /**
  * Default constructor.
  * Initializes all private members with default values.
@@ -20,9 +24,16 @@ Appetizer::Appetizer()
  * @param spiciness_level The spiciness level of the appetizer.
  * @param vegetarian Flag indicating if the appetizer is vegetarian.
  */
-Appetizer::Appetizer(const std::string& name, const std::vector<std::string>& ingredients, const int &prep_time, const double &price, const CuisineType &cuisine_type, const ServingStyle &serving_style, const int &spiciness_level, const bool &vegetarian)
+Appetizer::Appetizer(const std::string& name, const std::vector<std::string>& ingredients, const int &prep_time, const Money &price, const CuisineType &cuisine_type, const ServingStyle &serving_style, const int &spiciness_level, const bool &vegetarian)
     : Dish(name, ingredients, prep_time, price, cuisine_type), serving_style_(serving_style), spiciness_level_(spiciness_level), vegetarian_(vegetarian) {}
 
+/**
+ * Parameterized constructor taking ownership of an already parsed name and
+ * ingredient list, e.g. from a CSV loader.
+ */
+Appetizer::Appetizer(std::string&& name, std::vector<std::string>&& ingredients, const int &prep_time, const Money &price, const CuisineType &cuisine_type, const ServingStyle &serving_style, const int &spiciness_level, const bool &vegetarian)
+    : Dish(std::move(name), std::move(ingredients), prep_time, price, cuisine_type), serving_style_(serving_style), spiciness_level_(spiciness_level), vegetarian_(vegetarian) {}
+
 Appetizer::~Appetizer(){
     
 }
@@ -33,6 +44,7 @@ Appetizer::~Appetizer(){
  */
 void Appetizer::setServingStyle(const ServingStyle &serving_style) {
     serving_style_ = serving_style;
+    invalidateRender();
 }
 
 /**
@@ -49,6 +61,7 @@ Appetizer::ServingStyle Appetizer::getServingStyle() const {
  */
 void Appetizer::setSpicinessLevel(const int &spiciness_level) {
     spiciness_level_ = spiciness_level;
+    invalidateRender();
 }
 
 /**
@@ -65,6 +78,7 @@ int Appetizer::getSpicinessLevel() const {
  */
 void Appetizer::setVegetarian(const bool &vegetarian) {
     vegetarian_ = vegetarian;
+    invalidateRender();
 }
 
 /**
@@ -95,13 +109,31 @@ bool Appetizer::isVegetarian() const {
     * Vegetarian: [Yes/No]
     */
 void Appetizer::display(){
+    std::cout << getRendered();
+}
+
+/**
+ * Formats the appetizer's details in the layout documented for display().
+ * @param ingredients The ingredients to show.
+ * @param request The dietary accommodations to show, or nullptr for none.
+ * @return The formatted details; Dish::getRendered() caches them for the dish itself.
+ */
+std::string Appetizer::renderWith(const IngredientList& ingredients, const DietaryRequest* request) const {
+
     std::string ingredList = "";
-    std::vector<std::string> g = getIngredients();
-    for (int i = 0; i < g.size(); i++) {
-        if (i != 0) {
+    bool first = true;
+    for (std::string_view name : ingredients.names()) {
+        if (!first) {
             ingredList += ", "; 
         }
-        ingredList += g[i];
+        ingredList += name;
+        first = false;
+    }
+
+    int spiciness_level = spiciness_level_;
+    bool vegetarian = declaredAllergens(request) == 0;
+    if (request != nullptr && request->low_sodium) {
+        spiciness_level = std::max(spiciness_level - 2, 0);
     }
 
     ServingStyle m = getServingStyle();
@@ -123,14 +155,16 @@ void Appetizer::display(){
         x = "UNKNOWN";
         break;
     }
-    std::cout << "Dish Name: " << getName()  <<  std::endl <<
+    std::ostringstream out;
+    out << "Dish Name: " << getName()  <<  std::endl <<
     "Ingredients: " << ingredList  << std::endl <<
     "Preparation Time: " << getPrepTime() << " minutes" << std::endl <<
-    "Price: $" << std::fixed << std::setprecision(2) << getPrice() << std::endl << 
+    "Price: $" << getPrice() << std::endl <<
     "Cuisine Type: " << getCuisineType() << std::endl <<
     "Serving Style: " << x << std::endl <<
-    "Spiciness Level: " << spiciness_level_ << std::endl <<
-    "Vegetarian: " << (isVegetarian() ? "Yes" : "No") << std::endl;
+    "Spiciness Level: " << spiciness_level << std::endl <<
+    "Vegetarian: " << (vegetarian ? "Yes" : "No") << std::endl;
+    return out.str();
     
 
 
@@ -154,6 +188,8 @@ replaced with "Mushrooms". If there are more, they will be removed
 without substitution.
 * Non-vegetarian ingredients are: "Meat", "Chicken",
 "Fish", "Beef", "Pork", "Lamb", "Shrimp", "Bacon".
+* Ingredient classes and substitutes are those of the dietary rules,
+see `IngredientTable::loadRules()`; the lists here are the defaults.
 * - If `request.low_sodium` is true:
 * - Reduces `spiciness_level_` by 2 (minimum of 0).
 * - If `request.gluten_free` is true:
@@ -161,52 +197,91 @@ without substitution.
 `ingredients_`.
 * Gluten-containing ingredients are: "Wheat", "Flour",
 "Bread", "Pasta", "Barley", "Rye", "Oats", "Crust".
+* - Removes ingredients in the allergen classes of `request.avoid`.
 */
 void Appetizer::dietaryAccommodations(const DietaryRequest& request)  {
-    std::vector<std::string> ingredList = getIngredients();
-    int count = 0;
+    IngredientList ingredients = getIngredientIds();
+    DietaryMemo::instance().apply(dietaryPlan(request), ingredients);
+    applyDietaryResult(request, std::move(ingredients));
+}
+
+/**
+ * @param request The dietary accommodations.
+ * @return What `dietaryAccommodations()` does to the ingredients.
+ */
+DietaryPlan Appetizer::dietaryPlan(const DietaryRequest& request) const {
+    DietaryPlan plan;
     if (request.vegetarian) {
-        vegetarian_ = true;
-        for (int i = 0; i < ingredList.size();i++) {
-            if (ingredList[i] == "Meat" || ingredList[i] == "Chicken" || ingredList[i] == "Fish"
-            || ingredList[i] == "Beef" || ingredList[i] == "Pork" || ingredList[i] == "Lamb"
-            || ingredList[i] == "Shrimp" || ingredList[i] == "Bacon") {
-                if (count == 0) {
-                    ingredList[i] = "Beans";
-                }
-                else if (count == 1 ) {
-                    ingredList[i] = "Mushrooms";
-                }
-                else if (count > 1 ) {
-                    ingredList.erase(ingredList.begin() + i); 
-                    i--;
-                }
-                count++;
-            }
-        }
-        setIngredients(ingredList);
+        plan.substitute = IngredientTable::MEAT;
+    }
+    if (request.gluten_free) {
+        plan.remove |= IngredientTable::GLUTEN;
+    }
+    plan.remove |= request.avoid;
+    return plan;
+}
 
+/**
+ * Adjusts the remaining attributes as documented for `dietaryAccommodations()`.
+ * @param request The dietary accommodations.
+ * @param ingredients The ingredients with `dietaryPlan(request)` applied.
+ */
+void Appetizer::applyDietaryResult(const DietaryRequest& request, IngredientList&& ingredients) {
+    invalidateRender();
+    if (request.vegetarian) {
+        vegetarian_ = true;
     }
     if (request.low_sodium) {
         spiciness_level_ -= 2;
         if (spiciness_level_ < 0) {
             spiciness_level_ = 0;
         }
-
     }
-    if (request.gluten_free) {
-        for (int i = 0; i < ingredList.size();i++) {
-             if (ingredList[i] == "Wheat" || ingredList[i] == "Flour" || ingredList[i] == "Bread"
-            || ingredList[i] == "Pasta" || ingredList[i] == "Barley" || ingredList[i] == "Oats"
-            || ingredList[i] == "Rye" || ingredList[i] == "Crust") {
-                ingredList.erase(ingredList.begin()+i);
-                i--;
-            }
-
-        }
-        setIngredients(ingredList);
+    Dish::applyDietaryResult(request, std::move(ingredients));
+}
 
+/**
+ * @param request Dietary accommodations to take into account, or nullptr for none.
+ * @return MEAT unless the appetizer is flagged vegetarian.
+ */
+AllergenMask Appetizer::declaredAllergens(const DietaryRequest* request) const {
+    if (vegetarian_ || (request != nullptr && request->vegetarian)) {
+        return 0;
     }
+    return IngredientTable::MEAT;
 }
 
-
+/**
+ * Appends the appetizer as a JSON object, a Dishes.csv row (with newline) or a
+ binary record tagged 1.
+ * @param format The encoding to use.
+ * @param buffer The buffer to append to.
+ */
+void Appetizer::serialize(const Format& format, std::string& buffer) const {
+    SerialWriter writer(buffer);
+    serializeCommon(format, writer, "APPETIZER", 1);
+    switch (format) {
+        case JSON:
+            writer.text(",\"serving_style\":");
+            writer.jsonString(SERVING_STYLE_NAMES[serving_style_]);
+            writer.text(",\"spiciness_level\":");
+            writer.integer(spiciness_level_);
+            writer.text(",\"vegetarian\":");
+            writer.boolean(vegetarian_);
+            writer.character('}');
+            break;
+        case CSV:
+            writer.text(SERVING_STYLE_NAMES[serving_style_]);
+            writer.character(';');
+            writer.integer(spiciness_level_);
+            writer.character(';');
+            writer.boolean(vegetarian_);
+            writer.character('\n');
+            break;
+        case BINARY:
+            writer.byte(uint8_t(serving_style_));
+            writer.signedVarint(spiciness_level_);
+            writer.byte(vegetarian_);
+            break;
+    }
+}
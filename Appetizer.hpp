@@ -21,6 +21,11 @@ public:
      */
     enum ServingStyle { PLATED, FAMILY_STYLE, BUFFET };
 
+    /**
+     * Names of the ServingStyle enumerators, indexed by value.
+     */
+    static const char* const SERVING_STYLE_NAMES[BUFFET + 1];
+
     /**
      * Default constructor.
      * Initializes all private members with default values.
@@ -38,7 +43,18 @@ public:
      * @param spiciness_level The spiciness level of the appetizer.
      * @param vegetarian Flag indicating if the appetizer is vegetarian.
      */
-    Appetizer(const std::string& name, const std::vector<std::string>& ingredients, const int &prep_time, const double &price, const CuisineType &cuisine_type, const ServingStyle &serving_style, const int &spiciness_level, const bool &vegetarian);
+    Appetizer(const std::string& name, const std::vector<std::string>& ingredients, const int &prep_time, const Money &price, const CuisineType &cuisine_type, const ServingStyle &serving_style, const int &spiciness_level, const bool &vegetarian);
+
+    /**
+     * Parameterized constructor taking ownership of an already parsed name and
+     * ingredient list, e.g. from a CSV loader.
+     */
+    Appetizer(std::string&& name, std::vector<std::string>&& ingredients, const int &prep_time, const Money &price, const CuisineType &cuisine_type, const ServingStyle &serving_style, const int &spiciness_level, const bool &vegetarian);
+
+    Appetizer(const Appetizer&) = default;
+    Appetizer(Appetizer&&) = default;
+    Appetizer& operator=(const Appetizer&) = default;
+    Appetizer& operator=(Appetizer&&) = default;
 
     ~Appetizer() override;
     /**
@@ -111,6 +127,8 @@ replaced with "Mushrooms". If there are more, they will be removed
 without substitution.
 * Non-vegetarian ingredients are: "Meat", "Chicken",
 "Fish", "Beef", "Pork", "Lamb", "Shrimp", "Bacon".
+* Ingredient classes and substitutes are those of the dietary rules,
+see `IngredientTable::loadRules()`; the lists here are the defaults.
 * - If `request.low_sodium` is true:
 * - Reduces `spiciness_level_` by 2 (minimum of 0).
 * - If `request.gluten_free` is true:
@@ -118,9 +136,45 @@ without substitution.
 `ingredients_`.
 * Gluten-containing ingredients are: "Wheat", "Flour",
 "Bread", "Pasta", "Barley", "Rye", "Oats", "Crust".
+* - Removes ingredients in the allergen classes of `request.avoid`.
 */
 void dietaryAccommodations(const DietaryRequest& request) override;
 
+/**
+ * @param request The dietary accommodations.
+ * @return What `dietaryAccommodations()` does to the ingredients.
+ */
+DietaryPlan dietaryPlan(const DietaryRequest& request) const override;
+
+/**
+ * Adjusts the remaining attributes as documented for `dietaryAccommodations()`.
+ * @param request The dietary accommodations.
+ * @param ingredients The ingredients with `dietaryPlan(request)` applied.
+ */
+void applyDietaryResult(const DietaryRequest& request, IngredientList&& ingredients) override;
+
+/**
+ * Formats the appetizer's details in the layout documented for display().
+ * @param ingredients The ingredients to show.
+ * @param request The dietary accommodations to show, or nullptr for none.
+ * @return The formatted details; Dish::getRendered() caches them for the dish itself.
+ */
+std::string renderWith(const IngredientList& ingredients, const DietaryRequest* request) const override;
+
+/**
+ * Appends the appetizer as a JSON object, a Dishes.csv row (with newline) or a
+ binary record tagged 1.
+ * @param format The encoding to use.
+ * @param buffer The buffer to append to.
+ */
+void serialize(const Format& format, std::string& buffer) const override;
+
+protected:
+    /**
+     * @param request Dietary accommodations to take into account, or nullptr for none.
+     * @return MEAT unless the appetizer is flagged vegetarian.
+     */
+    AllergenMask declaredAllergens(const DietaryRequest* request) const override;
 
 private:
     ServingStyle serving_style_; ///< The serving style of the appetizer.
@@ -0,0 +1,108 @@
+#ifndef CHANNEL_HPP
+#define CHANNEL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * @class Channel
+ * @brief A bounded, blocking queue connecting the threads of a pipeline.
+ *
+ * Producers block while the channel is full, which is what propagates
+ * backpressure from a slow stage to the stages before it. Closing the
+ * channel lets consumers drain what is left; cancelling it wakes every
+ * waiting thread at once and makes all further pushes and pops fail.
+ */
+template <typename ItemType>
+class Channel {
+public:
+    /**
+     * @param capacity The number of items the channel holds before `push()` blocks, at least 1.
+     */
+    explicit Channel(const size_t& capacity) : capacity_(capacity < 1 ? 1 : capacity), closed_(false), cancelled_(false) {}
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    /**
+     * Waits for room, then appends an item.
+     * @return False, leaving `item` untouched, if the channel is closed or cancelled.
+     */
+    bool push(ItemType&& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]() { return items_.size() < capacity_ || closed_ || cancelled_; });
+        if (closed_ || cancelled_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /**
+     * Waits for an item and removes it.
+     * @param item Set to the oldest item on success.
+     * @return False if the channel is cancelled, or closed and empty.
+     */
+    bool pop(ItemType& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]() { return !items_.empty() || closed_ || cancelled_; });
+        if (cancelled_ || items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    /**
+     * Removes an item without waiting, even after cancellation, so the owner
+     can release what a cancelled pipeline left behind.
+     * @return False if the channel is empty.
+     */
+    bool tryPop(ItemType& item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    /**
+     * @post No more items are accepted; consumers receive the remaining ones.
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    /**
+     * @post Every waiting and future `push()` and `pop()` returns false.
+     */
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<ItemType> items_;
+    size_t capacity_;
+    bool closed_;
+    bool cancelled_;
+};
+
+#endif // CHANNEL_HPP
@@ -1,4 +1,8 @@
 #include "Dessert.hpp"
+#include "DietaryMemo.hpp"
+#include <algorithm>
+
+const char* const Dessert::FLAVOR_PROFILE_NAMES[UMAMI + 1] = { "SWEET", "BITTER", "SOUR", "SALTY", "UMAMI" };
 
 /**
  * Default constructor.
@@ -18,9 +22,16 @@ Dessert::Dessert()
  * @param sweetness_level The sweetness level of the dessert.
  * @param contains_nuts Flag indicating if the dessert contains nuts.
  */
-Dessert::Dessert(const std::string& name, const std::vector<std::string>& ingredients, const int &prep_time, const double &price, const CuisineType &cuisine_type, const FlavorProfile &flavor_profile, const int &sweetness_level, const bool &contains_nuts)
+Dessert::Dessert(const std::string& name, const std::vector<std::string>& ingredients, const int &prep_time, const Money &price, const CuisineType &cuisine_type, const FlavorProfile &flavor_profile, const int &sweetness_level, const bool &contains_nuts)
     : Dish(name, ingredients, prep_time, price, cuisine_type), flavor_profile_(flavor_profile), sweetness_level_(sweetness_level), contains_nuts_(contains_nuts) {}
 
+/**
+ * Parameterized constructor taking ownership of an already parsed name and
+ * ingredient list, e.g. from a CSV loader.
+ */
+Dessert::Dessert(std::string&& name, std::vector<std::string>&& ingredients, const int &prep_time, const Money &price, const CuisineType &cuisine_type, const FlavorProfile &flavor_profile, const int &sweetness_level, const bool &contains_nuts)
+    : Dish(std::move(name), std::move(ingredients), prep_time, price, cuisine_type), flavor_profile_(flavor_profile), sweetness_level_(sweetness_level), contains_nuts_(contains_nuts) {}
+
 
 Dessert::~Dessert() {
 }
@@ -31,6 +42,7 @@ Dessert::~Dessert() {
  */
 void Dessert::setFlavorProfile(const FlavorProfile &flavor_profile) {
     flavor_profile_ = flavor_profile;
+    invalidateRender();
 }
 
 /**
@@ -47,6 +59,7 @@ Dessert::FlavorProfile Dessert::getFlavorProfile() const {
  */
 void Dessert::setSweetnessLevel(const int &sweetness_level) {
     sweetness_level_ = sweetness_level;
+    invalidateRender();
 }
 
 /**
@@ -63,6 +76,7 @@ int Dessert::getSweetnessLevel() const {
  */
 void Dessert::setContainsNuts(const bool &contains_nuts) {
     contains_nuts_ = contains_nuts;
+    invalidateRender();
 }
 
 /**
@@ -92,16 +106,31 @@ whether it contains nuts.
 * Sweetness Level: [Sweetness level]
 * Contains Nuts: [Yes/No]
 */
-void Dessert::display()  {
+void Dessert::display(){
+    std::cout << getRendered();
+}
+
+/**
+ * Formats the dessert's details in the layout documented for display().
+ * @param ingredients The ingredients to show.
+ * @param request The dietary accommodations to show, or nullptr for none.
+ * @return The formatted details; Dish::getRendered() caches them for the dish itself.
+ */
+std::string Dessert::renderWith(const IngredientList& ingredients, const DietaryRequest* request) const {
+
     std::string ingredList = "";
-    std::vector<std::string> g = getIngredients();
-    for (int i = 0; i < g.size(); i++) {
-        if (i != 0) {
+    bool first = true;
+    for (std::string_view name : ingredients.names()) {
+        if (!first) {
             ingredList += ", "; 
         }
-        ingredList += g[i];
+        ingredList += name;
+        first = false;
     }
 
+    int sweetness_level = sweetnessWith(request);
+    bool contains_nuts = declaredAllergens(request) != 0;
+
     FlavorProfile m = getFlavorProfile();
     std::string x;
     switch(m) {
@@ -125,14 +154,16 @@ void Dessert::display()  {
         break;
       }
 
-    std::cout << "Dish Name: " << getName() << std::endl <<
+    std::ostringstream out;
+    out << "Dish Name: " << getName() << std::endl <<
     "Ingredients: " << ingredList << std::endl <<
     "Preparation Time: " << getPrepTime() << " minutes" << std::endl <<
-    "Price: $" << std::fixed << std::setprecision(2) << getPrice() << std::endl << 
+    "Price: $" << getPrice() << std::endl <<
     "Cuisine Type: " << getCuisineType() << std::endl <<
     "Flavor Profile: " << x << std::endl <<
-    "Sweetness Level: " << sweetness_level_ << std::endl <<
-    "Contains Nuts: " << (containsNuts() ? "Yes" : "No") << std::endl;
+    "Sweetness Level: " << sweetness_level << std::endl <<
+    "Contains Nuts: " << (contains_nuts ? "Yes" : "No") << std::endl;
+    return out.str();
     
 }
 
@@ -154,43 +185,98 @@ needs.
 * - Removes dairy and egg ingredients from `ingredients_`.
 * Dairy and egg ingredients are: "Milk", "Eggs", "Cheese",
 "Butter", "Cream", "Yogurt".
+* - Removes ingredients in the allergen classes of `request.avoid`.
 */
 
-void Dessert::dietaryAccommodations(const DietaryRequest& request) {
-    std::vector<std::string> ingredList = getIngredients();
-    if (request.nut_free) {
-        contains_nuts_ = false;
-        for (int i = 0; i < ingredList.size();i++) {
-             if (ingredList[i] == "Almonds" || ingredList[i] == "Walnuts" || ingredList[i] == "Pecans"
-            || ingredList[i] == "Hazelnuts" || ingredList[i] == "Peanuts" || ingredList[i] == "Cashews"
-            || ingredList[i] == "Pistachios") {
-                ingredList.erase(ingredList.begin()+i);
-                i--;
-            }
-        }
-        setIngredients(ingredList);
+void Dessert::dietaryAccommodations(const DietaryRequest& request)  {
+    IngredientList ingredients = getIngredientIds();
+    DietaryMemo::instance().apply(dietaryPlan(request), ingredients);
+    applyDietaryResult(request, std::move(ingredients));
+}
 
-    }
-    if (request.low_sugar) {
-        sweetness_level_ -= 3;
-        if (sweetness_level_ < 0 ) {
-            sweetness_level_ = 0;
-        }
+/**
+ * @param request The dietary accommodations.
+ * @return What `dietaryAccommodations()` does to the ingredients.
+ */
+DietaryPlan Dessert::dietaryPlan(const DietaryRequest& request) const {
+    DietaryPlan plan;
+    if (request.nut_free) {
+        plan.remove |= IngredientTable::NUTS;
     }
     if (request.vegan) {
-        for (int i = 0; i < ingredList.size();i++) {
-             if (ingredList[i] == "Milk" || ingredList[i] == "Eggs" || ingredList[i] == "Cheese"
-            || ingredList[i] == "Butter" || ingredList[i] == "Cream" || ingredList[i] == "Yogurt") {
-                ingredList.erase(ingredList.begin()+i);
-                i--;
-            }
-
-        }
-        setIngredients(ingredList);
-
+        plan.remove |= IngredientTable::DAIRY_EGG;
+    }
+    plan.remove |= request.avoid;
+    return plan;
+}
 
+/**
+ * Adjusts the remaining attributes as documented for `dietaryAccommodations()`.
+ * @param request The dietary accommodations.
+ * @param ingredients The ingredients with `dietaryPlan(request)` applied.
+ */
+void Dessert::applyDietaryResult(const DietaryRequest& request, IngredientList&& ingredients) {
+    invalidateRender();
+    if (request.nut_free) {
+        contains_nuts_ = false;
     }
+    sweetness_level_ = sweetnessWith(&request);
+    Dish::applyDietaryResult(request, std::move(ingredients));
+}
 
+/**
+ * @param request Dietary accommodations to apply first, or nullptr for the dessert as it is.
+ * @return The sweetness level, reduced by 3 (minimum of 0) for a low-sugar request.
+ */
+int Dessert::sweetnessWith(const DietaryRequest* request) const {
+    if (request != nullptr && request->low_sugar) {
+        return std::max(sweetness_level_ - 3, 0);
+    }
+    return sweetness_level_;
 }
 
+/**
+ * @param request Dietary accommodations to take into account, or nullptr for none.
+ * @return NUTS if the dessert is flagged as containing nuts.
+ */
+AllergenMask Dessert::declaredAllergens(const DietaryRequest* request) const {
+    if (contains_nuts_ && (request == nullptr || !request->nut_free)) {
+        return IngredientTable::NUTS;
+    }
+    return 0;
+}
 
+/**
+ * Appends the dessert as a JSON object, a Dishes.csv row (with newline) or a
+ binary record tagged 3.
+ * @param format The encoding to use.
+ * @param buffer The buffer to append to.
+ */
+void Dessert::serialize(const Format& format, std::string& buffer) const {
+    SerialWriter writer(buffer);
+    serializeCommon(format, writer, "DESSERT", 3);
+    switch (format) {
+        case JSON:
+            writer.text(",\"flavor_profile\":");
+            writer.jsonString(FLAVOR_PROFILE_NAMES[flavor_profile_]);
+            writer.text(",\"sweetness_level\":");
+            writer.integer(sweetness_level_);
+            writer.text(",\"contains_nuts\":");
+            writer.boolean(contains_nuts_);
+            writer.character('}');
+            break;
+        case CSV:
+            writer.text(FLAVOR_PROFILE_NAMES[flavor_profile_]);
+            writer.character(';');
+            writer.integer(sweetness_level_);
+            writer.character(';');
+            writer.boolean(contains_nuts_);
+            writer.character('\n');
+            break;
+        case BINARY:
+            writer.byte(uint8_t(flavor_profile_));
+            writer.signedVarint(sweetness_level_);
+            writer.byte(contains_nuts_);
+            break;
+    }
+}
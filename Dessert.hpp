@@ -19,6 +19,11 @@ public:
      */
     enum FlavorProfile { SWEET, BITTER, SOUR, SALTY, UMAMI };
 
+    /**
+     * Names of the FlavorProfile enumerators, indexed by value.
+     */
+    static const char* const FLAVOR_PROFILE_NAMES[UMAMI + 1];
+
     /**
      * Default constructor.
      * Initializes all private members with default values.
@@ -36,7 +41,18 @@ public:
      * @param sweetness_level The sweetness level of the dessert.
      * @param contains_nuts Flag indicating if the dessert contains nuts.
      */
-    Dessert(const std::string& name, const std::vector<std::string>& ingredients, const int &prep_time, const double &price, const CuisineType &cuisine_type, const FlavorProfile &flavor_profile, const int &sweetness_level, const bool &contains_nuts);
+    Dessert(const std::string& name, const std::vector<std::string>& ingredients, const int &prep_time, const Money &price, const CuisineType &cuisine_type, const FlavorProfile &flavor_profile, const int &sweetness_level, const bool &contains_nuts);
+
+    /**
+     * Parameterized constructor taking ownership of an already parsed name and
+     * ingredient list, e.g. from a CSV loader.
+     */
+    Dessert(std::string&& name, std::vector<std::string>&& ingredients, const int &prep_time, const Money &price, const CuisineType &cuisine_type, const FlavorProfile &flavor_profile, const int &sweetness_level, const bool &contains_nuts);
+
+    Dessert(const Dessert&) = default;
+    Dessert(Dessert&&) = default;
+    Dessert& operator=(const Dessert&) = default;
+    Dessert& operator=(Dessert&&) = default;
 
     ~Dessert() override;
     /**
@@ -115,10 +131,53 @@ needs.
 * - Removes dairy and egg ingredients from `ingredients_`.
 * Dairy and egg ingredients are: "Milk", "Eggs", "Cheese",
 "Butter", "Cream", "Yogurt".
+* - Removes ingredients in the allergen classes of `request.avoid`.
 */
 
 void dietaryAccommodations(const DietaryRequest& request) override;
 
+/**
+ * @param request The dietary accommodations.
+ * @return What `dietaryAccommodations()` does to the ingredients.
+ */
+DietaryPlan dietaryPlan(const DietaryRequest& request) const override;
+
+/**
+ * Adjusts the remaining attributes as documented for `dietaryAccommodations()`.
+ * @param request The dietary accommodations.
+ * @param ingredients The ingredients with `dietaryPlan(request)` applied.
+ */
+void applyDietaryResult(const DietaryRequest& request, IngredientList&& ingredients) override;
+
+/**
+ * Formats the dessert's details in the layout documented for display().
+ * @param ingredients The ingredients to show.
+ * @param request The dietary accommodations to show, or nullptr for none.
+ * @return The formatted details; Dish::getRendered() caches them for the dish itself.
+ */
+std::string renderWith(const IngredientList& ingredients, const DietaryRequest* request) const override;
+
+/**
+ * Appends the dessert as a JSON object, a Dishes.csv row (with newline) or a
+ binary record tagged 3.
+ * @param format The encoding to use.
+ * @param buffer The buffer to append to.
+ */
+void serialize(const Format& format, std::string& buffer) const override;
+
+/**
+ * @param request Dietary accommodations to apply first, or nullptr for the dessert as it is.
+ * @return The sweetness level, reduced by 3 (minimum of 0) for a low-sugar request.
+ */
+int sweetnessWith(const DietaryRequest* request) const override;
+
+protected:
+    /**
+     * @param request Dietary accommodations to take into account, or nullptr for none.
+     * @return NUTS if the dessert is flagged as containing nuts.
+     */
+    AllergenMask declaredAllergens(const DietaryRequest* request) const override;
+
 private:
     FlavorProfile flavor_profile_; ///< The flavor profile of the dessert.
     int sweetness_level_; ///< The sweetness level of the dessert.
@@ -0,0 +1,152 @@
+#include "DietaryIndex.hpp"
+#include "MemoryUsage.hpp"
+
+DietaryIndex::DietaryIndex() : size_(0) {
+}
+
+/**
+ * @param dish The dish added at position `size()`.
+ * @post The dish's properties are recorded at the new last position.
+ */
+void DietaryIndex::add(const Dish* dish) {
+    if (size_ % 64 == 0) {
+        for (int p = 0; p < PROPERTY_COUNT; p++) {
+            has_[p].push_back(0);
+            can_have_[p].push_back(0);
+        }
+    }
+    size_++;
+    store(size_ - 1, dish);
+}
+
+/**
+ * Mirrors removing the dish at a position by moving the last dish into it.
+ * @param position The position of the removed dish.
+ */
+void DietaryIndex::removeAt(const int& position) {
+    int last = size_ - 1;
+    for (int p = 0; p < PROPERTY_COUNT; p++) {
+        setBit(has_[p], position, getBit(has_[p], last));
+        setBit(can_have_[p], position, getBit(can_have_[p], last));
+        setBit(has_[p], last, false);
+        setBit(can_have_[p], last, false);
+    }
+    size_--;
+    if (size_ % 64 == 0) {
+        for (int p = 0; p < PROPERTY_COUNT; p++) {
+            has_[p].pop_back();
+            can_have_[p].pop_back();
+        }
+    }
+}
+
+/**
+ * @param position The position of a dish that changed in place.
+ * @param dish The dish at that position.
+ * @post The dish's properties are recomputed.
+ */
+void DietaryIndex::update(const int& position, const Dish* dish) {
+    store(position, dish);
+}
+
+/**
+ * @post The index is empty.
+ */
+void DietaryIndex::clear() {
+    for (int p = 0; p < PROPERTY_COUNT; p++) {
+        has_[p].clear();
+        can_have_[p].clear();
+    }
+    size_ = 0;
+}
+
+/**
+ * @return The number of positions in the index.
+ */
+int DietaryIndex::size() const {
+    return size_;
+}
+
+/**
+ * @param request The properties to require; `low_sodium` is ignored.
+ * @param include_adjustable If true, dishes that can be adjusted to meet
+ the request also match.
+ * @return The positions of all matching dishes, in increasing order.
+ */
+std::vector<int> DietaryIndex::match(const Dish::DietaryRequest& request, const bool& include_adjustable) const {
+    const bool wanted[PROPERTY_COUNT] = { request.vegetarian, request.vegan, request.gluten_free, request.nut_free, request.low_sugar };
+    const std::vector<uint64_t>* bitmaps = include_adjustable ? can_have_ : has_;
+    std::vector<int> positions;
+    int words = (size_ + 63) / 64;
+    for (int w = 0; w < words; w++) {
+        uint64_t word = w == words - 1 && size_ % 64 != 0 ? (uint64_t(1) << (size_ % 64)) - 1 : ~uint64_t(0);
+        for (int p = 0; p < PROPERTY_COUNT; p++) {
+            if (wanted[p]) {
+                word &= bitmaps[p][w];
+            }
+        }
+        while (word != 0) {
+            positions.push_back(w * 64 + __builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+    return positions;
+}
+
+/**
+ * @param property The property.
+ * @return The request that asks for this property alone.
+ */
+Dish::DietaryRequest DietaryIndex::requestFor(const Property& property) {
+    Dish::DietaryRequest request = {};
+    switch (property) {
+        case VEGETARIAN: request.vegetarian = true; break;
+        case VEGAN: request.vegan = true; break;
+        case GLUTEN_FREE: request.gluten_free = true; break;
+        case NUT_FREE: request.nut_free = true; break;
+        case LOW_SUGAR: request.low_sugar = true; break;
+        default: break;
+    }
+    return request;
+}
+
+/**
+ * @return The allocated size of the bitmaps.
+ */
+size_t DietaryIndex::heapBytes() const {
+    size_t bytes = 0;
+    for (int p = 0; p < PROPERTY_COUNT; p++) {
+        bytes += MemoryUsage::allocatedSize(has_[p]) + MemoryUsage::allocatedSize(can_have_[p]);
+    }
+    return bytes;
+}
+
+bool DietaryIndex::meets(const Dish* dish, const Property& property, const Dish::DietaryRequest* request) {
+    if (property == LOW_SUGAR) {
+        return dish->sweetnessWith(request) <= LOW_SUGAR_MAX_SWEETNESS;
+    }
+    return (dish->dietaryAllergens(request) & Dish::forbiddenAllergens(requestFor(property))) == 0;
+}
+
+void DietaryIndex::store(const int& position, const Dish* dish) {
+    for (int p = 0; p < PROPERTY_COUNT; p++) {
+        Property property = Property(p);
+        Dish::DietaryRequest request = requestFor(property);
+        bool has = meets(dish, property, nullptr);
+        setBit(has_[p], position, has);
+        setBit(can_have_[p], position, has || meets(dish, property, &request));
+    }
+}
+
+void DietaryIndex::setBit(std::vector<uint64_t>& bits, const int& position, const bool& value) {
+    uint64_t mask = uint64_t(1) << (position % 64);
+    if (value) {
+        bits[position / 64] |= mask;
+    } else {
+        bits[position / 64] &= ~mask;
+    }
+}
+
+bool DietaryIndex::getBit(const std::vector<uint64_t>& bits, const int& position) {
+    return (bits[position / 64] >> (position % 64)) & 1;
+}
@@ -0,0 +1,100 @@
+#ifndef DIETARY_INDEX_HPP
+#define DIETARY_INDEX_HPP
+
+#include "Dish.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class DietaryIndex
+ * @brief Bitmaps of dietary properties over the positions of a kitchen's dishes.
+ *
+ * For each property there are two bitmaps: dishes that already have it and
+ * dishes that have it or can get it through their own `dietaryAccommodations()`.
+ * Bit i describes the dish at position i of the kitchen's array, so the index
+ * mirrors the kitchen's add and swap-with-last remove. Filters combine the
+ * bitmaps 64 dishes per word.
+ */
+class DietaryIndex {
+public:
+    enum Property { VEGETARIAN, VEGAN, GLUTEN_FREE, NUT_FREE, LOW_SUGAR, PROPERTY_COUNT };
+
+    /**
+     * Desserts at or below this sweetness level count as low-sugar.
+     */
+    static const int LOW_SUGAR_MAX_SWEETNESS = 3;
+
+    /**
+     * Default constructor.
+     * Initializes an empty index.
+     */
+    DietaryIndex();
+
+    /**
+     * @param dish The dish added at position `size()`.
+     * @post The dish's properties are recorded at the new last position.
+     */
+    void add(const Dish* dish);
+
+    /**
+     * Mirrors removing the dish at a position by moving the last dish into it.
+     * @param position The position of the removed dish.
+     */
+    void removeAt(const int& position);
+
+    /**
+     * @param position The position of a dish that changed in place.
+     * @param dish The dish at that position.
+     * @post The dish's properties are recomputed.
+     */
+    void update(const int& position, const Dish* dish);
+
+    /**
+     * @post The index is empty.
+     */
+    void clear();
+
+    /**
+     * @return The number of positions in the index.
+     */
+    int size() const;
+
+    /**
+     * @param request The properties to require; `low_sodium` is ignored.
+     * @param include_adjustable If true, dishes that can be adjusted to meet
+     the request also match.
+     * @return The positions of all matching dishes, in increasing order.
+     */
+    std::vector<int> match(const Dish::DietaryRequest& request, const bool& include_adjustable) const;
+
+    /**
+     * @param property The property.
+     * @return The request that asks for this property alone.
+     */
+    static Dish::DietaryRequest requestFor(const Property& property);
+
+    /**
+     * @return The allocated size of the bitmaps.
+     */
+    size_t heapBytes() const;
+
+private:
+    std::vector<uint64_t> has_[PROPERTY_COUNT];
+    std::vector<uint64_t> can_have_[PROPERTY_COUNT];
+    int size_;
+
+    /**
+     * @return True if the dish meets the property, after `request` if not nullptr.
+     */
+    static bool meets(const Dish* dish, const Property& property, const Dish::DietaryRequest* request);
+
+    /**
+     * @post Bit `position` of each bitmap describes `dish`.
+     */
+    void store(const int& position, const Dish* dish);
+
+    static void setBit(std::vector<uint64_t>& bits, const int& position, const bool& value);
+    static bool getBit(const std::vector<uint64_t>& bits, const int& position);
+};
+
+#endif // DIETARY_INDEX_HPP
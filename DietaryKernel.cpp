@@ -0,0 +1,89 @@
+#include "DietaryKernel.hpp"
+
+/**
+ * @param plan The plan to apply.
+ * @param ingredients The ingredients of one dish.
+ * @post `ingredients` holds the kept and substituted ingredients in their original order.
+ */
+void DietaryKernel::apply(const DietaryPlan& plan, IngredientList& ingredients) {
+    if (!plan.changesIngredients() || ingredients.empty()) {
+        return;
+    }
+    std::vector<Substitutes> resolved;
+    const Substitutes& substitutes = substitutesFor(plan.substitute, resolved);
+    std::vector<AllergenMask> masks(ingredients.size());
+    IngredientTable::instance().allergensOf(ingredients.begin(), masks.size(), masks.data());
+    size_t kept = compact(plan, substitutes, ingredients.begin(), masks.data(), masks.size(), ingredients.begin());
+    ingredients.truncate(int(kept));
+}
+
+/**
+ * @param plans One plan per dish.
+ * @param ingredients The ingredients of all dishes, back to back.
+ * @param offsets `plans.size() + 1` offsets; dish d owns
+ `ingredients[offsets[d], offsets[d + 1])`.
+ * @post Each dish's range is compacted in place and the ranges are packed
+ to the front of `ingredients`, which is shrunk to fit. `offsets` describes
+ the new ranges.
+ */
+void DietaryKernel::apply(const std::vector<DietaryPlan>& plans, std::vector<IngredientId>& ingredients, std::vector<size_t>& offsets) {
+    std::vector<AllergenMask> masks(ingredients.size());
+    IngredientTable::instance().allergensOf(ingredients.data(), masks.size(), masks.data());
+
+    std::vector<Substitutes> resolved;
+    size_t write = 0;
+    for (size_t d = 0; d < plans.size(); d++) {
+        size_t begin = offsets[d];
+        size_t count = offsets[d + 1] - begin;
+        offsets[d] = write;
+        if (plans[d].changesIngredients()) {
+            const Substitutes& substitutes = substitutesFor(plans[d].substitute, resolved);
+            write += compact(plans[d], substitutes, ingredients.data() + begin, masks.data() + begin, count, ingredients.data() + write);
+        } else {
+            std::copy(ingredients.begin() + begin, ingredients.begin() + begin + count, ingredients.begin() + write);
+            write += count;
+        }
+    }
+    offsets[plans.size()] = write;
+    ingredients.resize(write);
+}
+
+const DietaryKernel::Substitutes& DietaryKernel::substitutesFor(const AllergenMask& allergen, std::vector<Substitutes>& resolved) {
+    for (const Substitutes& substitutes : resolved) {
+        if (substitutes.allergen == allergen) {
+            return substitutes;
+        }
+    }
+    const IngredientTable& table = IngredientTable::instance();
+    Substitutes substitutes;
+    substitutes.allergen = allergen;
+    if (allergen != 0) {
+        substitutes.ids = table.substitutesFor(allergen);
+        substitutes.masks.resize(substitutes.ids.size());
+        table.allergensOf(substitutes.ids.begin(), substitutes.masks.size(), substitutes.masks.data());
+    }
+    resolved.push_back(std::move(substitutes));
+    return resolved.back();
+}
+
+size_t DietaryKernel::compact(const DietaryPlan& plan, const Substitutes& substitutes, const IngredientId* ids, const AllergenMask* masks, const size_t& count, IngredientId* out) {
+    size_t kept = 0;
+    int substituted = 0;
+    for (size_t i = 0; i < count; i++) {
+        IngredientId id = ids[i];
+        AllergenMask mask = masks[i];
+        if (mask & plan.substitute) {
+            if (substituted == substitutes.ids.size()) {
+                continue;
+            }
+            id = substitutes.ids[substituted];
+            mask = substitutes.masks[substituted];
+            substituted++;
+        }
+        if (mask & plan.remove) {
+            continue;
+        }
+        out[kept++] = id;
+    }
+    return kept;
+}
@@ -0,0 +1,80 @@
+#ifndef DIETARY_KERNEL_HPP
+#define DIETARY_KERNEL_HPP
+
+#include "IngredientTable.hpp"
+#include <vector>
+
+/**
+ * @struct DietaryPlan
+ * @brief What a dietary request does to the ingredients of one dish.
+ *
+ * Ingredients of the `substitute` class are replaced, in order, by the
+ * substitutes of that class (see `IngredientTable::substitutesFor()`), and
+ * removed once the substitutes run out. Afterwards every ingredient in one
+ * of the `remove` classes is removed, including substitutes.
+ */
+struct DietaryPlan {
+    AllergenMask substitute = 0; // a single class bit, or 0
+    AllergenMask remove = 0;
+
+    /**
+     * @return True if the plan can change a dish's ingredients.
+     */
+    bool changesIngredients() const { return substitute != 0 || remove != 0; }
+};
+
+/**
+ * @class DietaryKernel
+ * @brief Applies dietary plans to ingredient lists with stable in-place compaction.
+ *
+ * Every ingredient is visited once and kept ingredients are written back
+ * over the same storage, so a pass costs O(n) with no allocation per dish.
+ * The batch form works on a whole kitchen's ingredients laid out in one flat
+ * buffer and looks up all allergen classes under a single table lock.
+ */
+class DietaryKernel {
+public:
+    /**
+     * @param plan The plan to apply.
+     * @param ingredients The ingredients of one dish.
+     * @post `ingredients` holds the kept and substituted ingredients in their original order.
+     */
+    static void apply(const DietaryPlan& plan, IngredientList& ingredients);
+
+    /**
+     * @param plans One plan per dish.
+     * @param ingredients The ingredients of all dishes, back to back.
+     * @param offsets `plans.size() + 1` offsets; dish d owns
+     `ingredients[offsets[d], offsets[d + 1])`.
+     * @post Each dish's range is compacted in place and the ranges are packed
+     to the front of `ingredients`, which is shrunk to fit. `offsets` describes
+     the new ranges.
+     */
+    static void apply(const std::vector<DietaryPlan>& plans, std::vector<IngredientId>& ingredients, std::vector<size_t>& offsets);
+
+private:
+    /**
+     * The substitutes of a class together with their own allergen classes.
+     */
+    struct Substitutes {
+        AllergenMask allergen = 0;
+        IngredientList ids;
+        std::vector<AllergenMask> masks;
+    };
+
+    /**
+     * @return The substitutes of `allergen`, resolved once per pass.
+     */
+    static const Substitutes& substitutesFor(const AllergenMask& allergen, std::vector<Substitutes>& resolved);
+
+    /**
+     * Compacts one dish's ingredients.
+     * @param ids The ingredient IDs, read from `ids[0, count)`.
+     * @param masks The allergen classes of the IDs.
+     * @param out Receives the kept IDs; may alias `ids`.
+     * @return The number of IDs written to `out`.
+     */
+    static size_t compact(const DietaryPlan& plan, const Substitutes& substitutes, const IngredientId* ids, const AllergenMask* masks, const size_t& count, IngredientId* out);
+};
+
+#endif // DIETARY_KERNEL_HPP
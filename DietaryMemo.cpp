@@ -0,0 +1,143 @@
+#include "DietaryMemo.hpp"
+
+DietaryMemo::DietaryMemo() : shard_capacity_(DEFAULT_CAPACITY / SHARD_COUNT), hits_(0), misses_(0) {
+}
+
+/**
+ * @return The process-wide memo.
+ */
+DietaryMemo& DietaryMemo::instance() {
+    static DietaryMemo memo;
+    return memo;
+}
+
+/**
+ * Applies a plan to one dish's ingredients, using a cached result if there is one.
+ * @param plan The plan to apply.
+ * @param ingredients The ingredients of one dish.
+ * @post `ingredients` is as after `DietaryKernel::apply(plan, ingredients)`.
+ */
+void DietaryMemo::apply(const DietaryPlan& plan, IngredientList& ingredients) {
+    if (!plan.changesIngredients()) {
+        return;
+    }
+    IngredientList result;
+    if (!find(ingredients, plan, result)) {
+        result = ingredients;
+        DietaryKernel::apply(plan, result);
+        store(ingredients, plan, result);
+    }
+    ingredients = std::move(result);
+}
+
+/**
+ * @param ingredients The ingredients before the plan is applied.
+ * @param plan The plan.
+ * @param result Receives the cached result, if any.
+ * @return True if a result was cached, false otherwise.
+ */
+bool DietaryMemo::find(const IngredientList& ingredients, const DietaryPlan& plan, IngredientList& result) {
+    Key key = makeKey(ingredients, plan);
+    size_t hash = KeyHash()(key);
+    Shard& shard = shards_[(hash >> 32) % SHARD_COUNT];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+        misses_++;
+        return false;
+    }
+    shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+    result = found->second->result;
+    hits_++;
+    return true;
+}
+
+/**
+ * @param ingredients The ingredients before the plan is applied.
+ * @param plan The plan.
+ * @param result The ingredients after the plan was applied.
+ * @post The result is cached, evicting the least recently used entry of its shard if full.
+ */
+void DietaryMemo::store(const IngredientList& ingredients, const DietaryPlan& plan, const IngredientList& result) {
+    Key key = makeKey(ingredients, plan);
+    size_t hash = KeyHash()(key);
+    Shard& shard = shards_[(hash >> 32) % SHARD_COUNT];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.index.find(key);
+    if (found != shard.index.end()) {
+        found->second->result = result;
+        shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+        return;
+    }
+    if (shard.entries.size() >= shard_capacity_) {
+        shard.index.erase(shard.entries.back().key);
+        shard.entries.pop_back();
+    }
+    shard.entries.push_front({ key, result });
+    shard.index.emplace(std::move(key), shard.entries.begin());
+}
+
+/**
+ * @param capacity The maximum number of cached results, at least one per shard.
+ * @post Empties the cache.
+ */
+void DietaryMemo::setCapacity(const size_t& capacity) {
+    for (Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.entries.clear();
+    }
+    shard_capacity_ = std::max(capacity / SHARD_COUNT, size_t(1));
+}
+
+/**
+ * @post Empties the cache and resets the hit and miss counts.
+ */
+void DietaryMemo::clear() {
+    for (Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.entries.clear();
+    }
+    hits_ = 0;
+    misses_ = 0;
+}
+
+/**
+ * @return The number of lookups answered from the cache.
+ */
+size_t DietaryMemo::hitCount() const {
+    return hits_;
+}
+
+/**
+ * @return The number of lookups that missed.
+ */
+size_t DietaryMemo::missCount() const {
+    return misses_;
+}
+
+DietaryMemo::Key DietaryMemo::makeKey(const IngredientList& ingredients, const DietaryPlan& plan) {
+    return { ingredients, plan.substitute, plan.remove, IngredientTable::instance().rulesVersion() };
+}
+
+bool DietaryMemo::Key::operator==(const Key& other) const {
+    return substitute == other.substitute && remove == other.remove
+        && rules_version == other.rules_version && ingredients == other.ingredients;
+}
+
+size_t DietaryMemo::KeyHash::operator()(const Key& key) const {
+    // FNV-1a over the plan, the rules version and the ingredient IDs
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint32_t value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+    mix(key.substitute);
+    mix(key.remove);
+    mix(key.rules_version);
+    for (const IngredientId& id : key.ingredients) {
+        mix(id);
+    }
+    return size_t(hash);
+}
@@ -0,0 +1,121 @@
+#ifndef DIETARY_MEMO_HPP
+#define DIETARY_MEMO_HPP
+
+#include "DietaryKernel.hpp"
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @class DietaryMemo
+ * @brief Process-wide, bounded cache of dietary results keyed by ingredient list and plan.
+ *
+ * Menus repeat the same recipes and guests repeat the same requests, so the
+ * ingredients a plan produces are remembered instead of recomputed. The
+ * result only depends on the ingredient IDs, the plan and the dietary rules,
+ * so dish type, subtype attributes and request flags enter the key through
+ * the plan. Entries are tagged with `IngredientTable::rulesVersion()` and
+ * stop matching when the rules are reloaded.
+ *
+ * The cache is split into independently locked shards, each evicting its
+ * least recently used entry when full.
+ */
+class DietaryMemo {
+public:
+    static const size_t DEFAULT_CAPACITY = 4096;
+
+    /**
+     * @return The process-wide memo.
+     */
+    static DietaryMemo& instance();
+
+    /**
+     * Applies a plan to one dish's ingredients, using a cached result if there is one.
+     * @param plan The plan to apply.
+     * @param ingredients The ingredients of one dish.
+     * @post `ingredients` is as after `DietaryKernel::apply(plan, ingredients)`.
+     */
+    void apply(const DietaryPlan& plan, IngredientList& ingredients);
+
+    /**
+     * @param ingredients The ingredients before the plan is applied.
+     * @param plan The plan.
+     * @param result Receives the cached result, if any.
+     * @return True if a result was cached, false otherwise.
+     */
+    bool find(const IngredientList& ingredients, const DietaryPlan& plan, IngredientList& result);
+
+    /**
+     * @param ingredients The ingredients before the plan is applied.
+     * @param plan The plan.
+     * @param result The ingredients after the plan was applied.
+     * @post The result is cached, evicting the least recently used entry of its shard if full.
+     */
+    void store(const IngredientList& ingredients, const DietaryPlan& plan, const IngredientList& result);
+
+    /**
+     * Must not be called while other threads use the memo.
+     * @param capacity The maximum number of cached results, at least one per shard.
+     * @post Empties the cache.
+     */
+    void setCapacity(const size_t& capacity);
+
+    /**
+     * @post Empties the cache and resets the hit and miss counts.
+     */
+    void clear();
+
+    /**
+     * @return The number of lookups answered from the cache.
+     */
+    size_t hitCount() const;
+
+    /**
+     * @return The number of lookups that missed.
+     */
+    size_t missCount() const;
+
+private:
+    static const int SHARD_COUNT = 16;
+
+    struct Key {
+        IngredientList ingredients;
+        AllergenMask substitute;
+        AllergenMask remove;
+        uint32_t rules_version;
+
+        bool operator==(const Key& other) const;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        Key key;
+        IngredientList result;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> entries; // most recently used first
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    };
+
+    Shard shards_[SHARD_COUNT];
+    size_t shard_capacity_;
+    std::atomic<size_t> hits_;
+    std::atomic<size_t> misses_;
+
+    DietaryMemo();
+    DietaryMemo(const DietaryMemo&) = delete;
+    DietaryMemo& operator=(const DietaryMemo&) = delete;
+
+    /**
+     * @return The key for a plan applied to the ingredients under the current rules.
+     */
+    static Key makeKey(const IngredientList& ingredients, const DietaryPlan& plan);
+};
+
+#endif // DIETARY_MEMO_HPP
@@ -0,0 +1,62 @@
+#include "DietaryOverlay.hpp"
+#include "DietaryMemo.hpp"
+
+/**
+ * @param base The dish to view.
+ * @param request The dietary accommodations to apply to the view.
+ */
+DietaryOverlay::DietaryOverlay(const Dish* base, const Dish::DietaryRequest& request) : base_(base), request_(request) {
+}
+
+/**
+ * @return The dish this overlay views.
+ */
+const Dish* DietaryOverlay::getBase() const {
+    return base_;
+}
+
+/**
+ * @return The dietary accommodations applied by this overlay.
+ */
+const Dish::DietaryRequest& DietaryOverlay::getRequest() const {
+    return request_;
+}
+
+/**
+ * @return The adjusted ingredient IDs.
+ */
+const IngredientList& DietaryOverlay::getIngredientIds() const {
+    std::call_once(ingredients_once_, [this]() {
+        ingredients_ = base_->getIngredientIds();
+        DietaryMemo::instance().apply(base_->dietaryPlan(request_), ingredients_);
+    });
+    return ingredients_;
+}
+
+/**
+ * @return The adjusted ingredient names.
+ */
+std::vector<std::string> DietaryOverlay::getIngredients() const {
+    return IngredientTable::instance().namesOf(getIngredientIds());
+}
+
+/**
+ * @return The allergen classes of the adjusted dish.
+ */
+AllergenMask DietaryOverlay::getAllergens() const {
+    return base_->allergensWith(getIngredientIds(), request_);
+}
+
+/**
+ * @return The adjusted dish's details in the base dish's `display()` format.
+ */
+std::string DietaryOverlay::render() const {
+    return base_->renderWith(getIngredientIds(), &request_);
+}
+
+/**
+ * Displays the adjusted dish's details.
+ */
+void DietaryOverlay::display() const {
+    std::cout << render();
+}
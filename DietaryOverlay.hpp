@@ -0,0 +1,74 @@
+#ifndef DIETARY_OVERLAY_HPP
+#define DIETARY_OVERLAY_HPP
+
+#include "Dish.hpp"
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class DietaryOverlay
+ * @brief A read-only view of a dish as it would be after `dietaryAccommodations()`.
+ *
+ * The base dish is never modified, so one menu can serve many guests with
+ * different requests at once. An overlay holds the base pointer, the request
+ * and the adjusted ingredient list, which is computed on first use (through
+ * the DietaryMemo) and then shared; all member functions are safe to call
+ * from several threads. Other adjusted attributes are derived from the base
+ * dish when needed.
+ * The base dish must outlive the overlay and must not change while it is in use.
+ */
+class DietaryOverlay {
+public:
+    /**
+     * @param base The dish to view.
+     * @param request The dietary accommodations to apply to the view.
+     */
+    DietaryOverlay(const Dish* base, const Dish::DietaryRequest& request);
+
+    DietaryOverlay(const DietaryOverlay&) = delete;
+    DietaryOverlay& operator=(const DietaryOverlay&) = delete;
+
+    /**
+     * @return The dish this overlay views.
+     */
+    const Dish* getBase() const;
+
+    /**
+     * @return The dietary accommodations applied by this overlay.
+     */
+    const Dish::DietaryRequest& getRequest() const;
+
+    /**
+     * @return The adjusted ingredient IDs.
+     */
+    const IngredientList& getIngredientIds() const;
+
+    /**
+     * @return The adjusted ingredient names.
+     */
+    std::vector<std::string> getIngredients() const;
+
+    /**
+     * @return The allergen classes of the adjusted dish.
+     */
+    AllergenMask getAllergens() const;
+
+    /**
+     * @return The adjusted dish's details in the base dish's `display()` format.
+     */
+    std::string render() const;
+
+    /**
+     * Displays the adjusted dish's details.
+     */
+    void display() const;
+
+private:
+    const Dish* base_;
+    Dish::DietaryRequest request_;
+    mutable std::once_flag ingredients_once_;
+    mutable IngredientList ingredients_; // set once by getIngredientIds()
+};
+
+#endif // DIETARY_OVERLAY_HPP
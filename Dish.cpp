@@ -1,14 +1,23 @@
 #include "Dish.hpp"
+#include "DietaryMemo.hpp"
 
 // Default Constructor
 Dish::Dish() 
-    : name_("UNKNOWN"), ingredients_({}), prep_time_(0), price_(0.0), cuisine_type_(CuisineType::OTHER) {
+    : name_("UNKNOWN"), ingredients_({}), prep_time_(0), price_(), cuisine_type_(CuisineType::OTHER), allergens_(0), render_dirty_(true) {
 }
 
 // Parameterized Constructor
-Dish::Dish(const std::string& name, const std::vector<std::string>& ingredients, int prep_time, double price, CuisineType cuisine_type)
-    : ingredients_(ingredients), prep_time_(prep_time), price_(price), cuisine_type_(cuisine_type) {
+Dish::Dish(const std::string& name, const std::vector<std::string>& ingredients, int prep_time, const Money& price, CuisineType cuisine_type)
+    : ingredients_(IngredientTable::instance().internAll(ingredients)), prep_time_(prep_time), price_(price), cuisine_type_(cuisine_type), render_dirty_(true) {
     setName(name);  // Use setName to validate the name
+    refreshAllergens();
+}
+
+// Parameterized Constructor taking ownership of parsed members
+Dish::Dish(std::string&& name, std::vector<std::string>&& ingredients, int prep_time, const Money& price, CuisineType cuisine_type)
+    : ingredients_(IngredientTable::instance().internAll(std::move(ingredients))), prep_time_(prep_time), price_(price), cuisine_type_(cuisine_type), render_dirty_(true) {
+    setName(std::move(name));  // Use setName to validate the name
+    refreshAllergens();
 }
 
 Dish::~Dish() {}
@@ -26,27 +35,65 @@ std::string Dish::getName() const {
 }
 
 std::vector<std::string> Dish::getIngredients() const {
+    return IngredientTable::instance().namesOf(ingredients_);
+}
+
+const IngredientList& Dish::getIngredientIds() const {
     return ingredients_;
 }
 
+int Dish::ingredientCount() const {
+    return ingredients_.size();
+}
+
+AllergenMask Dish::getAllergens() const {
+    return allergens_;
+}
+
+bool Dish::isCompatible(const DietaryRequest& request) const {
+    return (allergens_ & forbiddenAllergens(request)) == 0;
+}
+
+AllergenMask Dish::forbiddenAllergens(const DietaryRequest& request) {
+    AllergenMask forbidden = 0;
+    if (request.vegetarian || request.vegan) {
+        forbidden |= IngredientTable::MEAT;
+    }
+    if (request.vegan) {
+        forbidden |= IngredientTable::DAIRY_EGG;
+    }
+    if (request.gluten_free) {
+        forbidden |= IngredientTable::GLUTEN;
+    }
+    if (request.nut_free) {
+        forbidden |= IngredientTable::NUTS;
+    }
+    return forbidden | request.avoid;
+}
+
 int Dish::getPrepTime() const {
     return prep_time_;
 }
 
-double Dish::getPrice() const {
+Money Dish::getPrice() const {
     return price_;
 }
 
 std::string Dish::getCuisineType() const {
-    switch (cuisine_type_) {
-        case CuisineType::ITALIAN: return "ITALIAN";
-        case CuisineType::MEXICAN: return "MEXICAN";
-        case CuisineType::CHINESE: return "CHINESE";
-        case CuisineType::INDIAN: return "INDIAN";
-        case CuisineType::AMERICAN: return "AMERICAN";
-        case CuisineType::FRENCH: return "FRENCH";
-        default: return "OTHER";
+    return cuisineTypeToString(cuisine_type_);
+}
+
+Dish::CuisineType Dish::getCuisineTypeEnum() const {
+    return cuisine_type_;
+}
+
+const char* const Dish::CUISINE_TYPE_NAMES[OTHER + 1] = { "ITALIAN", "MEXICAN", "CHINESE", "INDIAN", "AMERICAN", "FRENCH", "OTHER" };
+
+std::string Dish::cuisineTypeToString(const CuisineType& cuisine_type) {
+    if (cuisine_type < ITALIAN || cuisine_type > OTHER) {
+        return CUISINE_TYPE_NAMES[OTHER];
     }
+    return CUISINE_TYPE_NAMES[cuisine_type];
 }
 
 // Mutator Functions
@@ -56,22 +103,55 @@ void Dish::setName(const std::string& name) {
     } else {
         name_ = "UNKNOWN";
     }
+    invalidateRender();
+}
+
+void Dish::setName(std::string&& name) {
+    if (isValidName(name)) {
+        name_ = std::move(name);
+    } else {
+        name_ = "UNKNOWN";
+    }
+    invalidateRender();
 }
 
 void Dish::setIngredients(const std::vector<std::string>& ingredients) {
-    ingredients_ = ingredients;
+    ingredients_ = IngredientTable::instance().internAll(ingredients);
+    refreshAllergens();
+    invalidateRender();
+}
+
+void Dish::setIngredients(std::vector<std::string>&& ingredients) {
+    ingredients_ = IngredientTable::instance().internAll(std::move(ingredients));
+    refreshAllergens();
+    invalidateRender();
+}
+
+void Dish::setIngredientIds(const IngredientList& ingredient_ids) {
+    ingredients_ = ingredient_ids;
+    refreshAllergens();
+    invalidateRender();
+}
+
+void Dish::setIngredientIds(IngredientList&& ingredient_ids) {
+    ingredients_ = std::move(ingredient_ids);
+    refreshAllergens();
+    invalidateRender();
 }
 
 void Dish::setPrepTime(const int& prep_time) {
     prep_time_ = prep_time;
+    invalidateRender();
 }
 
-void Dish::setPrice(const double& price) {
+void Dish::setPrice(const Money& price) {
     price_ = price;
+    invalidateRender();
 }
 
 void Dish::setCuisineType(const CuisineType& cuisine_type) {
     cuisine_type_ = cuisine_type;
+    invalidateRender();
 }
 
 
@@ -85,6 +165,99 @@ bool Dish::isValidName(const std::string& name) const {
     return true;  // Name is valid
 }
 
+const std::string& Dish::getRendered() const {
+    if (render_dirty_) {
+        rendered_ = renderWith(ingredients_, nullptr);
+        render_dirty_ = false;
+    }
+    return rendered_;
+}
+
+void Dish::invalidateRender() {
+    render_dirty_ = true;
+    revision_.value = Revision::next();
+}
+
+uint64_t Dish::revision() const {
+    return revision_.value;
+}
+
+uint64_t Dish::latestRevision() {
+    return Revision::latest.load();
+}
+
+std::atomic<uint64_t> Dish::Revision::latest(0);
+
+AllergenMask Dish::componentAllergens(const DietaryRequest* request) const {
+    return 0;
+}
+
+void Dish::refreshAllergens() {
+    allergens_ = IngredientTable::instance().allergensOf(ingredients_) | componentAllergens(nullptr);
+}
+
+AllergenMask Dish::declaredAllergens(const DietaryRequest* request) const {
+    return 0;
+}
+
+/**
+ * @param request Dietary accommodations to apply first, or nullptr for the dish as it is.
+ * @return The allergen classes of the dish's ingredients and parts, plus
+ those its own flags declare.
+ */
+AllergenMask Dish::dietaryAllergens(const DietaryRequest* request) const {
+    if (request == nullptr) {
+        return allergens_ | declaredAllergens(nullptr);
+    }
+    DietaryPlan plan = dietaryPlan(*request);
+    if ((allergens_ & (plan.substitute | plan.remove)) == 0) {
+        // no ingredient belongs to a class the plan touches, so none would change
+        return allergensWith(ingredients_, *request) | declaredAllergens(request);
+    }
+    IngredientList ingredients = ingredients_;
+    DietaryMemo::instance().apply(plan, ingredients);
+    return allergensWith(ingredients, *request) | declaredAllergens(request);
+}
+
+/**
+ * @param request Dietary accommodations to apply first, or nullptr for the dish as it is.
+ * @return How sweet the dish is; 0 unless a derived class has a sweetness level.
+ */
+int Dish::sweetnessWith(const DietaryRequest* request) const {
+    return 0;
+}
+
+/**
+ * Adds the heap blocks the dish owns, not the dish object itself, to `usage`.
+ * @param usage The totals to add to.
+ */
+void Dish::addMemoryUsage(MemoryUsage& usage) const {
+    usage.names += MemoryUsage::allocatedSize(name_);
+    usage.ingredients += ingredients_.heapBytes();
+    usage.caches += MemoryUsage::allocatedSize(rendered_);
+}
+
+/**
+ * @param ingredients The ingredients after `dietaryPlan(request)` was applied.
+ * @param request The dietary accommodations.
+ * @return The allergen classes the dish would have after `dietaryAccommodations(request)`.
+ */
+AllergenMask Dish::allergensWith(const IngredientList& ingredients, const DietaryRequest& request) const {
+    return IngredientTable::instance().allergensOf(ingredients) | componentAllergens(&request);
+}
+
+/**
+ * Completes a dietary accommodation whose ingredients were already adjusted by DietaryKernel.
+ * @param request The dietary accommodations.
+ * @param ingredients The ingredients with `dietaryPlan(request)` applied.
+ * @post Stores `ingredients` if the plan changes ingredients.
+ */
+void Dish::applyDietaryResult(const DietaryRequest& request, IngredientList&& ingredients) {
+    if (dietaryPlan(request).changesIngredients()) {
+        setIngredientIds(std::move(ingredients));
+    }
+}
+
 bool Dish::operator==(const Dish& rhs) const {
     return name_ == rhs.name_ && prep_time_ == rhs.prep_time_ && 
     price_ == rhs.price_ && cuisine_type_ == rhs.cuisine_type_;
@@ -92,4 +265,68 @@ bool Dish::operator==(const Dish& rhs) const {
 
 bool Dish::operator!=(const Dish& rhs) const {
     return !(*this == rhs);
-}
\ No newline at end of file
+}
+
+/**
+ * Writes the fields shared by all dishes; derived classes append their own
+ fields and finish the record.
+ * @param type_name The dish type as named in Dishes.csv, e.g. "APPETIZER".
+ * @param tag The binary record tag of the dish type.
+ */
+void Dish::serializeCommon(const Format& format, SerialWriter& writer, const char* type_name, const uint8_t& tag) const {
+    const char* cuisine_name = CUISINE_TYPE_NAMES[cuisine_type_ < ITALIAN || cuisine_type_ > OTHER ? OTHER : cuisine_type_];
+    bool first = true;
+    switch (format) {
+        case JSON:
+            writer.text("{\"type\":");
+            writer.jsonString(type_name);
+            writer.text(",\"name\":");
+            writer.jsonString(name_);
+            writer.text(",\"ingredients\":[");
+            for (std::string_view name : ingredients_.names()) {
+                if (!first) {
+                    writer.character(',');
+                }
+                writer.jsonString(name);
+                first = false;
+            }
+            writer.text("],\"prep_time\":");
+            writer.integer(prep_time_);
+            writer.text(",\"price\":");
+            writer.money(price_);
+            writer.text(",\"cuisine_type\":");
+            writer.jsonString(cuisine_name);
+            break;
+        case CSV:
+            writer.text(type_name);
+            writer.character(',');
+            writer.text(name_);
+            writer.character(',');
+            for (std::string_view name : ingredients_.names()) {
+                if (!first) {
+                    writer.character(';');
+                }
+                writer.text(name);
+                first = false;
+            }
+            writer.character(',');
+            writer.integer(prep_time_);
+            writer.character(',');
+            writer.money(price_);
+            writer.character(',');
+            writer.text(cuisine_name);
+            writer.character(',');
+            break;
+        case BINARY:
+            writer.byte(tag);
+            writer.bytes(name_);
+            writer.varint(ingredients_.size());
+            for (std::string_view name : ingredients_.names()) {
+                writer.bytes(name);
+            }
+            writer.signedVarint(prep_time_);
+            writer.signedVarint(price_.getCents());
+            writer.byte(uint8_t(cuisine_type_));
+            break;
+    }
+}
@@ -5,17 +5,30 @@
 #ifndef DISH_HPP
 #define DISH_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <iostream>
 #include <iomanip> // For std::fixed and std::setprecision
+#include <sstream> // For rendering display text
 #include <cctype>  // For std::isalpha, std::isspace
+#include "DietaryKernel.hpp"
+#include "IngredientTable.hpp"
+#include "MemoryUsage.hpp"
+#include "Money.hpp"
+#include "Serializable.hpp"
 
-class Dish {
+class Dish : public Serializable {
 public:
     // CuisineType enum definition
     enum CuisineType { ITALIAN, MEXICAN, CHINESE, INDIAN, AMERICAN, FRENCH, OTHER };
 
+    /**
+     * Names of the CuisineType enumerators, indexed by value.
+     */
+    static const char* const CUISINE_TYPE_NAMES[OTHER + 1];
+
     /**
     * Structure to store dietary accommodation details.
     */
@@ -26,6 +39,9 @@ public:
     bool nut_free;
     bool low_sodium;
     bool low_sugar;
+    // Further allergen classes to exclude, as bits from `IngredientTable::allergenClass()`;
+    // this is how a request names classes defined by `IngredientTable::loadRules()`.
+    AllergenMask avoid = 0;
     };
     // Constructors
     /**
@@ -34,7 +50,7 @@ public:
      * - name: "UNKNOWN"
      * - ingredients: Empty list
      * - prep_time: 0
-     * - price: 0.0
+     * - price: $0.00
      * - cuisine_type: OTHER
      */
     Dish();
@@ -44,11 +60,27 @@ public:
      * @param name A reference to the name of the dish.
      * @param ingredients A reference to a list of ingredients (default is an empty list).
      * @param prep_time The preparation time in minutes (default is 0).
-     * @param price The price of the dish (default is 0.0).
+     * @param price The price of the dish (default is $0.00).
      * @param cuisine_type The cuisine type of the dish (a CuisineType enum) with default value OTHER.
      * @post The private members are set to the values of the corresponding parameters.
      */
-    Dish(const std::string& name, const std::vector<std::string>& ingredients = std::vector<std::string>(), int prep_time = 0, double price = 0.0, CuisineType cuisine_type = CuisineType::OTHER);
+    Dish(const std::string& name, const std::vector<std::string>& ingredients = std::vector<std::string>(), int prep_time = 0, const Money& price = Money(), CuisineType cuisine_type = CuisineType::OTHER);
+
+    /**
+     * Parameterized constructor taking ownership of already parsed members.
+     * @param name The name of the dish, moved into the dish.
+     * @param ingredients The ingredient names, moved into the ingredient table when new.
+     * @param prep_time The preparation time in minutes.
+     * @param price The price of the dish.
+     * @param cuisine_type The cuisine type of the dish (a CuisineType enum).
+     * @post The private members are set to the values of the corresponding parameters.
+     */
+    Dish(std::string&& name, std::vector<std::string>&& ingredients, int prep_time, const Money& price, CuisineType cuisine_type);
+
+    Dish(const Dish&) = default;
+    Dish(Dish&&) = default;
+    Dish& operator=(const Dish&) = default;
+    Dish& operator=(Dish&&) = default;
 
     virtual ~Dish() = 0;
     // Accessors
@@ -62,6 +94,34 @@ public:
      */
     std::vector<std::string> getIngredients() const;
 
+    /**
+     * @return The interned IDs of the ingredients used in the dish.
+     */
+    const IngredientList& getIngredientIds() const;
+
+    /**
+     * @return The number of ingredients used in the dish.
+     */
+    int ingredientCount() const;
+
+    /**
+     * @return The allergen classes contained in the dish (see IngredientTable::Allergen).
+     */
+    AllergenMask getAllergens() const;
+
+    /**
+     * @param request A reference to a DietaryRequest structure.
+     * @return True if the dish, as it is now, contains none of the allergen
+     classes the request excludes, false otherwise.
+     */
+    bool isCompatible(const DietaryRequest& request) const;
+
+    /**
+     * @param request A reference to a DietaryRequest structure.
+     * @return The allergen classes a dish must not contain to satisfy the request.
+     */
+    static AllergenMask forbiddenAllergens(const DietaryRequest& request);
+
     /**
      * @return The preparation time in minutes.
      */
@@ -70,13 +130,24 @@ public:
     /**
      * @return The price of the dish.
      */
-    double getPrice() const;
+    Money getPrice() const;
 
     /**
      * @return The cuisine type of the dish in string form.
      */
     std::string getCuisineType() const;
 
+    /**
+     * @return The cuisine type of the dish as a CuisineType enum.
+     */
+    CuisineType getCuisineTypeEnum() const;
+
+    /**
+     * @param cuisine_type A CuisineType enum.
+     * @return The cuisine type in string form, e.g. "ITALIAN".
+     */
+    static std::string cuisineTypeToString(const CuisineType& cuisine_type);
+
     // Mutators
     /**
      * Sets the name of the dish.
@@ -84,6 +155,7 @@ public:
      * @post Sets the private member `name_` to the value of the parameter. If the name contains non-alphabetic characters, it is set to "UNKNOWN".
      */
     void setName(const std::string& name);
+    void setName(std::string&& name);
 
     /**
      * Sets the list of ingredients.
@@ -91,6 +163,15 @@ public:
      * @post Sets the private member `ingredients_` to the value of the parameter.
      */
     void setIngredients(const std::vector<std::string>& ingredients);
+    void setIngredients(std::vector<std::string>&& ingredients);
+
+    /**
+     * Sets the list of ingredients from already interned IDs.
+     * @param ingredient_ids A reference to the new list of ingredient IDs.
+     * @post Sets the private member `ingredients_` to the value of the parameter.
+     */
+    void setIngredientIds(const IngredientList& ingredient_ids);
+    void setIngredientIds(IngredientList&& ingredient_ids);
 
     /**
      * Sets the preparation time.
@@ -104,7 +185,7 @@ public:
      * @param price The new price of the dish.
      * @post Sets the private member `price_` to the value of the parameter.
      */
-    void setPrice(const double& price);
+    void setPrice(const Money& price);
 
     /**
      * Sets the cuisine type of the dish.
@@ -119,6 +200,38 @@ public:
     **/
     virtual void display() = 0;
 
+    /**
+     * @return The dish's details in the `display()` format. The text is cached
+     and only rebuilt if the dish changed since it was last rendered.
+     */
+    const std::string& getRendered() const;
+
+    /**
+     * As `getRendered()`, but rebuilds the text with `DishType::renderWith()`
+     called directly instead of through the vtable.
+     * @tparam DishType The dish's own concrete type.
+     */
+    template <class DishType>
+    const std::string& getRenderedAs() const {
+        if (render_dirty_) {
+            rendered_ = static_cast<const DishType*>(this)->DishType::renderWith(ingredients_, nullptr);
+            render_dirty_ = false;
+        }
+        return rendered_;
+    }
+
+    /**
+     * @return A number that changes whenever the dish is constructed, copied
+     or changed through a member function; see `invalidateRender()`.
+     */
+    uint64_t revision() const;
+
+    /**
+     * @return The newest revision of any dish. If it has not changed since an
+     earlier call, no dish has changed in between.
+     */
+    static uint64_t latestRevision();
+
 
     /**
     * Modifies the dish to accommodate specific dietary needs.
@@ -128,6 +241,65 @@ public:
     */
     virtual void dietaryAccommodations(const DietaryRequest& request) = 0;
 
+    /**
+    * Describes how `dietaryAccommodations()` changes the dish's ingredients,
+    so that DietaryKernel can apply it to many dishes at once.
+    * Must be overridden by derived classes.
+    * @param request The dietary accommodations.
+    * @return The ingredient classes to substitute and to remove.
+    */
+    virtual DietaryPlan dietaryPlan(const DietaryRequest& request) const = 0;
+
+    /**
+    * Completes a dietary accommodation whose ingredients were already
+    adjusted by DietaryKernel. Applying the kernel to `getIngredientIds()` and
+    then calling this is equivalent to `dietaryAccommodations(request)`.
+    * Derived classes override this to adjust their own attributes and then
+    call the base version.
+    * @param request The dietary accommodations.
+    * @param ingredients The ingredients with `dietaryPlan(request)` applied.
+    * @post Stores `ingredients` if the plan changes ingredients.
+    */
+    virtual void applyDietaryResult(const DietaryRequest& request, IngredientList&& ingredients);
+
+    /**
+    * Formats the dish's details for `display()`, as they would read with the
+    given ingredients and after `dietaryAccommodations(*request)`, without
+    changing the dish.
+    * Must be overridden by derived classes.
+    * @param ingredients The ingredients to show.
+    * @param request The dietary accommodations to show, or nullptr for none.
+    * @return The formatted details.
+    */
+    virtual std::string renderWith(const IngredientList& ingredients, const DietaryRequest* request) const = 0;
+
+    /**
+    * @param ingredients The ingredients after `dietaryPlan(request)` was applied.
+    * @param request The dietary accommodations.
+    * @return The allergen classes the dish would have after `dietaryAccommodations(request)`.
+    */
+    AllergenMask allergensWith(const IngredientList& ingredients, const DietaryRequest& request) const;
+
+    /**
+    * @param request Dietary accommodations to apply first, or nullptr for the dish as it is.
+    * @return The allergen classes of the dish's ingredients and parts, plus
+    those its own flags declare (see `declaredAllergens()`).
+    */
+    AllergenMask dietaryAllergens(const DietaryRequest* request) const;
+
+    /**
+    * @param request Dietary accommodations to apply first, or nullptr for the dish as it is.
+    * @return How sweet the dish is; 0 unless a derived class has a sweetness level.
+    */
+    virtual int sweetnessWith(const DietaryRequest* request) const;
+
+    /**
+    * Adds the heap blocks the dish owns, not the dish object itself, to `usage`.
+    * Derived classes with further heap members override this and call the base.
+    * @param usage The totals to add to.
+    */
+    virtual void addMemoryUsage(MemoryUsage& usage) const;
+
     /**
      @param : A const reference to the right-hand side of the `==` operator.
     @return : Returns true if the right-hand side dish is "equal", false
@@ -146,12 +318,74 @@ public:
     */
     bool operator!=(const Dish& rhs) const; // Overloading the != operator
 
+protected:
+    /**
+     * @param request Dietary accommodations to take into account, or nullptr for none.
+     * @return Allergen classes contributed by parts of the dish other than its
+     ingredients. Derived classes override this; the default is none.
+     */
+    virtual AllergenMask componentAllergens(const DietaryRequest* request) const;
+
+    /**
+     * @param request Dietary accommodations to take into account, or nullptr for none.
+     * @return Allergen classes the dish declares through its own flags rather
+     than its ingredients, e.g. a dessert marked as containing nuts. Derived
+     classes override this; the default is none.
+     */
+    virtual AllergenMask declaredAllergens(const DietaryRequest* request) const;
+
+    /**
+     * Writes the fields shared by all dishes. Derived classes then append
+     their own fields and finish the record: JSON leaves the object open, CSV
+     ends with the separator before the additional attributes, and BINARY
+     starts with `tag`.
+     * @param type_name The dish type as named in Dishes.csv, e.g. "APPETIZER".
+     * @param tag The binary record tag of the dish type.
+     */
+    void serializeCommon(const Format& format, SerialWriter& writer, const char* type_name, const uint8_t& tag) const;
+
+    /**
+     * Recomputes the allergen mask from the ingredients and `componentAllergens()`.
+     * @post Sets the private member `allergens_`.
+     */
+    void refreshAllergens();
+
+    /**
+     * Marks the cached display text as out of date and gives the dish a new
+     `revision()`, so a Kitchen holding it recounts it.
+     * Must be called by every member function that changes displayed state.
+     */
+    void invalidateRender();
+
 private:
+    /**
+     * A revision drawn from one counter shared by all dishes. Constructing,
+     copying or assigning one draws a new value, so a dish assigned over
+     never keeps an old revision.
+     */
+    struct Revision {
+        Revision() : value(next()) {}
+        Revision(const Revision&) : value(next()) {}
+        Revision& operator=(const Revision&) {
+            value = next();
+            return *this;
+        }
+        static uint64_t next() {
+            return ++latest;
+        }
+        static std::atomic<uint64_t> latest;
+        uint64_t value;
+    };
+
     std::string name_;
-    std::vector<std::string> ingredients_;
+    IngredientList ingredients_; // interned, see IngredientTable
     int prep_time_;
-    double price_;
+    Money price_;
     CuisineType cuisine_type_;
+    AllergenMask allergens_; // cached, kept current by the ingredient setters
+    mutable std::string rendered_; // cached display text, see getRendered()
+    mutable bool render_dirty_;
+    Revision revision_;
 
     // Helper function to check if the name is valid
     /**
@@ -0,0 +1,152 @@
+#include "DishCsv.hpp"
+#include "Appetizer.hpp"
+#include "Dessert.hpp"
+#include "MainCourse.hpp"
+
+namespace {
+
+// Index of `name` in a table of enumerator names, 0 if it is not found.
+template <size_t N>
+int enumIndex(const std::string& name, const char* const (&names)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (names[i] == name) {
+            return int(i);
+        }
+    }
+    return 0;
+}
+
+bool parseBool(const std::string& text) {
+    return text == "true" || text == "TRUE" || text == "1";
+}
+
+} // namespace
+
+/**
+ * Parses one row of a dishes CSV file.
+ * @param row A line of the file, without the trailing newline.
+ * @return A newly allocated dish, or nullptr if the row is malformed.
+ * The caller takes ownership of the returned dish.
+ */
+Dish* DishCsv::parseRow(const std::string& row) {
+    std::string line = row;
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+    std::vector<std::string> fields = split(line, ',');
+    if (fields.size() != 7) {
+        return nullptr;
+    }
+    std::vector<std::string> attributes = split(fields[6], ';');
+    if (attributes.size() != (fields[0] == "MAINCOURSE" ? 4 : 3)) {
+        return nullptr;
+    }
+
+    int prep_time;
+    Money price;
+    try {
+        prep_time = std::stoi(fields[3]);
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+    if (!Money::parse(fields[4], price)) {
+        return nullptr;
+    }
+    std::vector<std::string> ingredients = split(fields[2], ';');
+    Dish::CuisineType cuisine_type = parseCuisineType(fields[5]);
+
+    try {
+        if (fields[0] == "APPETIZER") {
+            return new Appetizer(std::move(fields[1]), std::move(ingredients), prep_time, price, cuisine_type,
+                Appetizer::ServingStyle(enumIndex(attributes[0], Appetizer::SERVING_STYLE_NAMES)), std::stoi(attributes[1]), parseBool(attributes[2]));
+        }
+        if (fields[0] == "DESSERT") {
+            return new Dessert(std::move(fields[1]), std::move(ingredients), prep_time, price, cuisine_type,
+                Dessert::FlavorProfile(enumIndex(attributes[0], Dessert::FLAVOR_PROFILE_NAMES)), std::stoi(attributes[1]), parseBool(attributes[2]));
+        }
+        if (fields[0] == "MAINCOURSE") {
+            std::vector<MainCourse::SideDish> side_dishes;
+            for (std::string& side : split(attributes[2], '|')) {
+                size_t colon = side.rfind(':');
+                std::string category = colon == std::string::npos ? "" : side.substr(colon + 1);
+                side.resize(colon == std::string::npos ? side.size() : colon);
+                side_dishes.push_back({ std::move(side), MainCourse::Category(enumIndex(category, MainCourse::CATEGORY_NAMES)) });
+            }
+            return new MainCourse(std::move(fields[1]), std::move(ingredients), prep_time, price, cuisine_type,
+                MainCourse::CookingMethod(enumIndex(attributes[0], MainCourse::COOKING_METHOD_NAMES)), std::move(attributes[1]), std::move(side_dishes),
+                parseBool(attributes[3]));
+        }
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+    return nullptr;
+}
+
+/**
+ * Splits a string on a delimiter.
+ * @return The fields between delimiters; an empty string yields no fields.
+ */
+std::vector<std::string> DishCsv::split(const std::string& text, const char& delimiter) {
+    std::vector<std::string> fields;
+    if (text.empty()) {
+        return fields;
+    }
+    size_t start = 0;
+    while (true) {
+        size_t end = text.find(delimiter, start);
+        if (end == std::string::npos) {
+            fields.push_back(text.substr(start));
+            return fields;
+        }
+        fields.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+/**
+ * @return The CuisineType column of a row as written; empty if the row is malformed.
+ */
+std::string DishCsv::cuisineName(const std::string& row) {
+    std::string line = row;
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+    std::vector<std::string> fields = split(line, ',');
+    return fields.size() == 7 ? fields[5] : std::string();
+}
+
+/**
+ * Appends a dish as a CSV row with the given CuisineType column.
+ * @param cuisine_name The column to write; if empty, the dish's own cuisine type.
+ */
+void DishCsv::formatRow(const Dish& dish, const std::string& cuisine_name, std::string& buffer) {
+    size_t begin = buffer.size();
+    dish.serialize(Serializable::CSV, buffer);
+    if (cuisine_name.empty()) {
+        return;
+    }
+    // the cuisine is the sixth column; no earlier column can hold a comma
+    for (int column = 0; column < 5; column++) {
+        begin = buffer.find(',', begin);
+        if (begin == std::string::npos) {
+            return;
+        }
+        begin++;
+    }
+    size_t end = buffer.find(',', begin);
+    if (end != std::string::npos) {
+        buffer.replace(begin, end - begin, cuisine_name);
+    }
+}
+
+/**
+ * @return The CuisineType with the given name, or OTHER if there is none.
+ */
+Dish::CuisineType DishCsv::parseCuisineType(const std::string& name) {
+    for (int i = Dish::ITALIAN; i < Dish::OTHER; i++) {
+        if (name == Dish::CUISINE_TYPE_NAMES[i]) {
+            return Dish::CuisineType(i);
+        }
+    }
+    return Dish::OTHER;
+}
@@ -0,0 +1,57 @@
+#ifndef DISH_CSV_HPP
+#define DISH_CSV_HPP
+
+#include "Dish.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @class DishCsv
+ * @brief Parses rows in the `Dishes.csv` format into dishes.
+ *
+ * A row has the columns
+ * DishType,Name,Ingredients,PreparationTime,Price,CuisineType,AdditionalAttributes
+ * where ingredients are separated by ';' and the additional attributes are
+ * - APPETIZER: ServingStyle;SpicinessLevel;Vegetarian
+ * - MAINCOURSE: CookingMethod;ProteinType;Side:CATEGORY|Side:CATEGORY;GlutenFree
+ * - DESSERT: FlavorProfile;SweetnessLevel;ContainsNuts
+ * Unknown enum names fall back to the first enumerator (OTHER for cuisines).
+ */
+class DishCsv {
+public:
+    /**
+     * Parses one row of a dishes CSV file.
+     * @param row A line of the file, without the trailing newline.
+     * @return A newly allocated dish, or nullptr if the row is malformed.
+     * The caller takes ownership of the returned dish.
+     */
+    static Dish* parseRow(const std::string& row);
+
+    /**
+     * Splits a string on a delimiter.
+     * @return The fields between delimiters; an empty string yields no fields.
+     */
+    static std::vector<std::string> split(const std::string& text, const char& delimiter);
+
+    /**
+     * @return The CuisineType with the given name, or OTHER if there is none.
+     */
+    static Dish::CuisineType parseCuisineType(const std::string& name);
+
+    /**
+     * @param row A line of the file, without the trailing newline.
+     * @return The CuisineType column as written, e.g. "JAPANESE", which
+     `parseRow()` reads as OTHER; empty if the row is malformed.
+     */
+    static std::string cuisineName(const std::string& row);
+
+    /**
+     * Appends a dish as a row, newline included, as `Dish::serialize()` with
+     the CSV format does, but with the given CuisineType column.
+     * @param cuisine_name The column to write, e.g. from `cuisineName()`; if
+     empty, the dish's own cuisine type is written.
+     */
+    static void formatRow(const Dish& dish, const std::string& cuisine_name, std::string& buffer);
+};
+
+#endif // DISH_CSV_HPP
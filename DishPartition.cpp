@@ -0,0 +1,126 @@
+#include "DishPartition.hpp"
+
+static const uint32_t FREE_SLOT = UINT32_MAX;
+
+/** default constructor**/
+template<class DishType>
+DishPartition<DishType>::DishPartition()
+{
+}  // end default constructor
+
+/**
+ @param dish the dish to store, moved into the partition
+ @return the slot of the stored dish
+ **/
+template<class DishType>
+uint32_t DishPartition<DishType>::add(DishType&& dish)
+{
+   uint32_t slot;
+   if (free_slots_.empty())
+   {
+      slot = uint32_t(slot_to_dense_.size());
+      slot_to_dense_.push_back(0);
+      generations_.push_back(0);
+   }
+   else
+   {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+   }  // end if
+   slot_to_dense_[slot] = uint32_t(dishes_.size());
+   dense_to_slot_.push_back(slot);
+   dishes_.push_back(std::move(dish));
+   return slot;
+}  // end add
+
+/**
+ @return true if the dish at slot/generation was removed, false if the handle is stale
+ **/
+template<class DishType>
+bool DishPartition<DishType>::remove(const uint32_t& slot, const uint32_t& generation)
+{
+   if (!isLive(slot, generation))
+   {
+      return false;
+   }
+   uint32_t hole = slot_to_dense_[slot];
+   uint32_t last = uint32_t(dishes_.size()) - 1;
+   if (hole != last)
+   {
+      dishes_[hole] = std::move(dishes_[last]);
+      dense_to_slot_[hole] = dense_to_slot_[last];
+      slot_to_dense_[dense_to_slot_[hole]] = hole;
+   }  // end if
+   dishes_.pop_back();
+   dense_to_slot_.pop_back();
+   slot_to_dense_[slot] = FREE_SLOT;
+   generations_[slot]++;
+   free_slots_.push_back(slot);
+   return true;
+}  // end remove
+
+/**
+ @return the dish at slot/generation, or nullptr if the handle is stale
+ **/
+template<class DishType>
+DishType* DishPartition<DishType>::get(const uint32_t& slot, const uint32_t& generation)
+{
+   return isLive(slot, generation) ? &dishes_[slot_to_dense_[slot]] : nullptr;
+}  // end get
+
+/**
+ @return the current generation of slot
+ **/
+template<class DishType>
+uint32_t DishPartition<DishType>::getGeneration(const uint32_t& slot) const
+{
+   return generations_[slot];
+}  // end getGeneration
+
+/**
+ @return the number of dishes in the partition
+ **/
+template<class DishType>
+int DishPartition<DishType>::getCurrentSize() const
+{
+   return int(dishes_.size());
+}  // end getCurrentSize
+
+/**
+ @return the dishes of the partition, densely packed
+ **/
+template<class DishType>
+std::vector<DishType>& DishPartition<DishType>::getDishes()
+{
+   return dishes_;
+}  // end getDishes
+
+template<class DishType>
+const std::vector<DishType>& DishPartition<DishType>::getDishes() const
+{
+   return dishes_;
+}  // end getDishes
+
+/**
+ @post all dishes are removed and all handles go stale
+ **/
+template<class DishType>
+void DishPartition<DishType>::clear()
+{
+   while (!dishes_.empty())
+   {
+      uint32_t slot = dense_to_slot_.back();
+      remove(slot, generations_[slot]);
+   }  // end while
+}  // end clear
+
+// ********* PRIVATE METHODS **************//
+
+/**
+ @return true if slot/generation names a stored dish
+ **/
+template<class DishType>
+bool DishPartition<DishType>::isLive(const uint32_t& slot, const uint32_t& generation) const
+{
+   return slot < slot_to_dense_.size() && slot_to_dense_[slot] != FREE_SLOT && generations_[slot] == generation;
+}  // end isLive
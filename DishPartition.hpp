@@ -0,0 +1,75 @@
+#ifndef DISH_PARTITION_HPP
+#define DISH_PARTITION_HPP
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class DishPartition
+ * @brief Contiguous by-value storage for dishes of a single concrete type.
+ *
+ * Dishes live densely packed in one vector so loops over a partition touch
+ * consecutive memory. Removal swaps the last dish into the hole; callers keep
+ * stable (slot, generation) handles that are translated to the current
+ * position, and a handle goes stale once its dish has been removed.
+ */
+template <class DishType>
+class DishPartition
+{
+   public:
+   /** default constructor**/
+   DishPartition();
+
+   /**
+       @param dish the dish to store, moved into the partition
+       @return the slot of the stored dish
+   **/
+   uint32_t add(DishType&& dish);
+
+   /**
+       @return true if the dish at slot/generation was removed, false if the handle is stale
+   **/
+   bool remove(const uint32_t& slot, const uint32_t& generation);
+
+   /**
+       @return the dish at slot/generation, or nullptr if the handle is stale
+   **/
+   DishType* get(const uint32_t& slot, const uint32_t& generation);
+
+   /**
+       @return the current generation of slot
+   **/
+   uint32_t getGeneration(const uint32_t& slot) const;
+
+   /**
+       @return the number of dishes in the partition
+   **/
+   int getCurrentSize() const;
+
+   /**
+       @return the dishes of the partition, densely packed
+   **/
+   std::vector<DishType>& getDishes();
+   const std::vector<DishType>& getDishes() const;
+
+   /**
+       @post all dishes are removed and all handles go stale
+   **/
+   void clear();
+
+   private:
+   std::vector<DishType> dishes_;        // dense storage
+   std::vector<uint32_t> dense_to_slot_; // slot of dishes_[i]
+   std::vector<uint32_t> slot_to_dense_; // position in dishes_ of each slot
+   std::vector<uint32_t> generations_;   // bumped whenever a slot is freed
+   std::vector<uint32_t> free_slots_;
+
+   /**
+       @return true if slot/generation names a stored dish
+   **/
+   bool isLive(const uint32_t& slot, const uint32_t& generation) const;
+
+}; // end DishPartition
+
+#include "DishPartition.cpp"
+#endif
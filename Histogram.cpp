@@ -0,0 +1,139 @@
+#include "Histogram.hpp"
+#include "MemoryUsage.hpp"
+
+/**
+ * Default constructor.
+ * Initializes an empty histogram.
+ */
+Histogram::Histogram()
+    : counts_(BUCKET_COUNT, 0), lowest_(BUCKET_COUNT, 0), highest_(BUCKET_COUNT, 0), count_(0), min_index_(BUCKET_COUNT), max_index_(-1) {
+}
+
+/**
+ * Records a value.
+ * @param value The value to record. Negative values are recorded as 0.
+ * @post The bucket holding `value` is incremented.
+ */
+void Histogram::add(const long long& value) {
+    int index = indexOf(value);
+    long long recorded = value < 0 ? 0 : value;
+    if (counts_[index] == 0 || recorded < lowest_[index]) {
+        lowest_[index] = recorded;
+    }
+    if (counts_[index] == 0 || recorded > highest_[index]) {
+        highest_[index] = recorded;
+    }
+    counts_[index]++;
+    count_++;
+    if (index < min_index_) {
+        min_index_ = index;
+    }
+    if (index > max_index_) {
+        max_index_ = index;
+    }
+}
+
+/**
+ * Adds all values recorded in another histogram to this one.
+ * @param other The histogram to merge in.
+ */
+void Histogram::merge(const Histogram& other) {
+    for (int i = other.min_index_; i <= other.max_index_; i++) {
+        if (other.counts_[i] == 0) {
+            continue;
+        }
+        if (counts_[i] == 0 || other.lowest_[i] < lowest_[i]) {
+            lowest_[i] = other.lowest_[i];
+        }
+        if (counts_[i] == 0 || other.highest_[i] > highest_[i]) {
+            highest_[i] = other.highest_[i];
+        }
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    if (other.min_index_ < min_index_) {
+        min_index_ = other.min_index_;
+    }
+    if (other.max_index_ > max_index_) {
+        max_index_ = other.max_index_;
+    }
+}
+
+/**
+ * @post The histogram holds no values.
+ */
+void Histogram::clear() {
+    counts_.assign(BUCKET_COUNT, 0);
+    lowest_.assign(BUCKET_COUNT, 0);
+    highest_.assign(BUCKET_COUNT, 0);
+    count_ = 0;
+    min_index_ = BUCKET_COUNT;
+    max_index_ = -1;
+}
+
+/**
+ * @return The number of values currently recorded.
+ */
+long long Histogram::getCount() const {
+    return count_;
+}
+
+/**
+ * @param percentile The percentile to look up, between 0 and 100.
+ * @return A recorded value from the bucket holding the given percentile, or 0 if empty.
+ */
+long long Histogram::getPercentile(const double& percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    // rank of the value we are looking for, 1-based
+    long long rank = (long long)(percentile / 100.0 * count_ + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+    if (rank > count_) {
+        rank = count_;
+    }
+    long long seen = 0;
+    for (int i = min_index_; i <= max_index_; i++) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            return seen == rank ? highest_[i] : lowest_[i];
+        }
+    }
+    return highest_[max_index_];
+}
+
+/**
+ * @return The smallest recorded value, or 0 if empty.
+ */
+long long Histogram::getMin() const {
+    return count_ == 0 ? 0 : lowest_[min_index_];
+}
+
+/**
+ * @return The largest recorded value, or 0 if empty.
+ */
+long long Histogram::getMax() const {
+    return count_ == 0 ? 0 : highest_[max_index_];
+}
+
+/**
+ * @return The allocated size of the bucket arrays.
+ */
+size_t Histogram::heapBytes() const {
+    return MemoryUsage::allocatedSize(counts_) + MemoryUsage::allocatedSize(lowest_) + MemoryUsage::allocatedSize(highest_);
+}
+
+// ********* PRIVATE METHODS **************//
+
+int Histogram::indexOf(long long value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return value < 0 ? 0 : int(value);
+    }
+    // position of the highest set bit decides how far the value is scaled down
+    int highest_bit = 63 - __builtin_clzll((unsigned long long)value);
+    int shift = highest_bit - (SUB_BUCKET_BITS - 1);
+    int index = SUB_BUCKET_COUNT + (shift - 1) * HALF_SUB_BUCKET_COUNT + int(value >> shift) - HALF_SUB_BUCKET_COUNT;
+    return index < BUCKET_COUNT ? index : BUCKET_COUNT - 1;
+}
@@ -0,0 +1,92 @@
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class Histogram
+ * @brief A fixed-bucket, log-linear histogram of non-negative integer values.
+ *
+ * Values below 256 get a bucket each; larger values share buckets whose width
+ * is at most 1/128 of the value. Each bucket also keeps the smallest and
+ * largest value recorded in it, so the minimum and maximum are exact and a
+ * percentile is always a value that was recorded, within 0.8% of the true
+ * one. The bucket layout is fixed, which makes histograms mergeable and keeps
+ * every query independent of how many values were recorded.
+ */
+class Histogram {
+public:
+    /**
+     * Default constructor.
+     * Initializes an empty histogram.
+     */
+    Histogram();
+
+    /**
+     * Records a value.
+     * @param value The value to record. Negative values are recorded as 0.
+     * @post The bucket holding `value` is incremented.
+     */
+    void add(const long long& value);
+
+    /**
+     * Adds all values recorded in another histogram to this one.
+     * @param other The histogram to merge in.
+     */
+    void merge(const Histogram& other);
+
+    /**
+     * @post The histogram holds no values.
+     */
+    void clear();
+
+    /**
+     * @return The number of values currently recorded.
+     */
+    long long getCount() const;
+
+    /**
+     * @param percentile The percentile to look up, between 0 and 100.
+     * @return A recorded value from the bucket holding the given percentile:
+     the largest if the percentile is the last value in the bucket, else the
+     smallest. Exact below 256. 0 if empty.
+     */
+    long long getPercentile(const double& percentile) const;
+
+    /**
+     * @return The smallest recorded value, or 0 if empty.
+     */
+    long long getMin() const;
+
+    /**
+     * @return The largest recorded value, or 0 if empty.
+     */
+    long long getMax() const;
+
+    /**
+     * @return The allocated size of the bucket arrays.
+     */
+    size_t heapBytes() const;
+
+private:
+    static const int SUB_BUCKET_BITS = 8;
+    static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const int HALF_SUB_BUCKET_COUNT = SUB_BUCKET_COUNT / 2;
+    static const int MAX_VALUE_BITS = 40;
+    static const int BUCKET_COUNT = SUB_BUCKET_COUNT + (MAX_VALUE_BITS - SUB_BUCKET_BITS) * HALF_SUB_BUCKET_COUNT;
+
+    std::vector<long long> counts_;
+    std::vector<long long> lowest_;  // smallest value recorded per bucket
+    std::vector<long long> highest_; // largest value recorded per bucket
+    long long count_;
+    int min_index_; // lowest non-empty bucket, BUCKET_COUNT when empty
+    int max_index_; // highest non-empty bucket, -1 when empty
+
+    /**
+     * @return The index of the bucket holding `value`.
+     */
+    static int indexOf(long long value);
+};
+
+#endif // HISTOGRAM_HPP
@@ -0,0 +1,217 @@
+#include "IngredientList.hpp"
+#include "IngredientTable.hpp"
+#include "MemoryUsage.hpp"
+#include <algorithm>
+
+IngredientList::NameIterator::NameIterator(const IngredientId* position) : position_(position) {
+}
+
+std::string_view IngredientList::NameIterator::operator*() const {
+    return IngredientTable::instance().nameOf(*position_);
+}
+
+IngredientList::NameIterator& IngredientList::NameIterator::operator++() {
+    position_++;
+    return *this;
+}
+
+bool IngredientList::NameIterator::operator!=(const NameIterator& rhs) const {
+    return position_ != rhs.position_;
+}
+
+/**
+ * Default constructor.
+ * Initializes an empty list.
+ */
+IngredientList::IngredientList() : size_(0), capacity_(INLINE_CAPACITY) {
+}
+
+IngredientList::IngredientList(const std::vector<IngredientId>& ids) : size_(0), capacity_(INLINE_CAPACITY) {
+    reserve(uint32_t(ids.size()));
+    std::copy(ids.begin(), ids.end(), data());
+    size_ = uint32_t(ids.size());
+}
+
+IngredientList::IngredientList(std::initializer_list<IngredientId> ids) : size_(0), capacity_(INLINE_CAPACITY) {
+    reserve(uint32_t(ids.size()));
+    std::copy(ids.begin(), ids.end(), data());
+    size_ = uint32_t(ids.size());
+}
+
+IngredientList::IngredientList(const IngredientId* first, const IngredientId* last) : size_(0), capacity_(INLINE_CAPACITY) {
+    reserve(uint32_t(last - first));
+    std::copy(first, last, data());
+    size_ = uint32_t(last - first);
+}
+
+IngredientList::IngredientList(const IngredientList& other) : size_(0), capacity_(INLINE_CAPACITY) {
+    reserve(other.size_);
+    std::copy(other.begin(), other.end(), data());
+    size_ = other.size_;
+}
+
+IngredientList::IngredientList(IngredientList&& other) noexcept : size_(other.size_), capacity_(other.capacity_) {
+    if (other.isSpilled()) {
+        heap_ = other.heap_;
+        other.capacity_ = INLINE_CAPACITY;
+    } else {
+        std::copy(other.inline_, other.inline_ + other.size_, inline_);
+    }
+    other.size_ = 0;
+}
+
+IngredientList& IngredientList::operator=(const IngredientList& other) {
+    if (this != &other) {
+        size_ = 0;
+        reserve(other.size_);
+        std::copy(other.begin(), other.end(), data());
+        size_ = other.size_;
+    }
+    return *this;
+}
+
+IngredientList& IngredientList::operator=(IngredientList&& other) noexcept {
+    if (this != &other) {
+        if (isSpilled()) {
+            delete[] heap_;
+        }
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        if (other.isSpilled()) {
+            heap_ = other.heap_;
+            other.capacity_ = INLINE_CAPACITY;
+        } else {
+            std::copy(other.inline_, other.inline_ + other.size_, inline_);
+        }
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+IngredientList::~IngredientList() {
+    if (isSpilled()) {
+        delete[] heap_;
+    }
+}
+
+int IngredientList::size() const {
+    return int(size_);
+}
+
+bool IngredientList::empty() const {
+    return size_ == 0;
+}
+
+const IngredientId& IngredientList::operator[](const int& index) const {
+    return data()[index];
+}
+
+IngredientId& IngredientList::operator[](const int& index) {
+    return data()[index];
+}
+
+const IngredientId* IngredientList::begin() const {
+    return data();
+}
+
+const IngredientId* IngredientList::end() const {
+    return data() + size_;
+}
+
+IngredientId* IngredientList::begin() {
+    return data();
+}
+
+IngredientId* IngredientList::end() {
+    return data() + size_;
+}
+
+/**
+ * Appends an ingredient, moving the list to the heap if it outgrows the inline buffer.
+ * @param id The ingredient ID to append.
+ */
+void IngredientList::push_back(const IngredientId& id) {
+    if (size_ == capacity_) {
+        reserve(capacity_ * 2);
+    }
+    data()[size_] = id;
+    size_++;
+}
+
+/**
+ * Removes one ingredient, keeping the order of the others.
+ * @param position A pointer to the ingredient to remove.
+ * @return A pointer to the ingredient that followed the removed one.
+ */
+IngredientId* IngredientList::erase(IngredientId* position) {
+    std::copy(position + 1, end(), position);
+    size_--;
+    return position;
+}
+
+/**
+ * Shrinks the list to its first `count` ingredients.
+ * @param count The new size, at most `size()`.
+ */
+void IngredientList::truncate(const int& count) {
+    if (count < int(size_)) {
+        size_ = uint32_t(count);
+    }
+}
+
+/**
+ * @post The list is empty.
+ */
+void IngredientList::clear() {
+    size_ = 0;
+}
+
+bool IngredientList::isSpilled() const {
+    return capacity_ > INLINE_CAPACITY;
+}
+
+size_t IngredientList::heapBytes() const {
+    return isSpilled() ? MemoryUsage::allocatedSize(heap_) : 0;
+}
+
+/**
+ * @return The ingredient names, as string views into IngredientTable.
+ */
+IngredientList::NameRange IngredientList::names() const {
+    return { NameIterator(begin()), NameIterator(end()) };
+}
+
+std::vector<IngredientId> IngredientList::toVector() const {
+    return std::vector<IngredientId>(begin(), end());
+}
+
+bool IngredientList::operator==(const IngredientList& rhs) const {
+    return size_ == rhs.size_ && std::equal(begin(), end(), rhs.begin());
+}
+
+bool IngredientList::operator!=(const IngredientList& rhs) const {
+    return !(*this == rhs);
+}
+
+// ********* PRIVATE METHODS **************//
+
+void IngredientList::reserve(const uint32_t& capacity) {
+    if (capacity <= capacity_) {
+        return;
+    }
+    IngredientId* buffer = new IngredientId[capacity];
+    std::copy(begin(), end(), buffer);
+    if (isSpilled()) {
+        delete[] heap_;
+    }
+    heap_ = buffer;
+    capacity_ = capacity;
+}
+
+IngredientId* IngredientList::data() {
+    return isSpilled() ? heap_ : inline_;
+}
+
+const IngredientId* IngredientList::data() const {
+    return isSpilled() ? heap_ : inline_;
+}
@@ -0,0 +1,161 @@
+#ifndef INGREDIENT_LIST_HPP
+#define INGREDIENT_LIST_HPP
+
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+/**
+ * Compact identifier of an interned ingredient name.
+ */
+typedef uint32_t IngredientId;
+
+/**
+ * @class IngredientList
+ * @brief A list of ingredient IDs stored inline in the owning object.
+ *
+ * Up to INLINE_CAPACITY IDs are kept inside the list itself, which covers
+ * almost every dish, so building or copying such a list does not allocate.
+ * Longer lists spill to a heap buffer.
+ */
+class IngredientList {
+public:
+    static const uint32_t INLINE_CAPACITY = 6;
+
+    /**
+     * @class NameIterator
+     * @brief Iterates over the names of the ingredients, resolved through IngredientTable.
+     */
+    class NameIterator {
+    public:
+        explicit NameIterator(const IngredientId* position);
+        std::string_view operator*() const;
+        NameIterator& operator++();
+        bool operator!=(const NameIterator& rhs) const;
+    private:
+        const IngredientId* position_;
+    };
+
+    /**
+     * @struct NameRange
+     * @brief The ingredient names of a list, for use in range-based for loops.
+     */
+    struct NameRange {
+        NameIterator first;
+        NameIterator last;
+        NameIterator begin() const { return first; }
+        NameIterator end() const { return last; }
+    };
+
+    /**
+     * Default constructor.
+     * Initializes an empty list.
+     */
+    IngredientList();
+
+    /**
+     * Converting constructors.
+     * @param ids The ingredient IDs to store, in order.
+     */
+    IngredientList(const std::vector<IngredientId>& ids);
+    IngredientList(std::initializer_list<IngredientId> ids);
+
+    /**
+     * @param first The first of a contiguous run of ingredient IDs.
+     * @param last One past the last ID of the run.
+     */
+    IngredientList(const IngredientId* first, const IngredientId* last);
+
+    IngredientList(const IngredientList& other);
+    IngredientList(IngredientList&& other) noexcept;
+    IngredientList& operator=(const IngredientList& other);
+    IngredientList& operator=(IngredientList&& other) noexcept;
+    ~IngredientList();
+
+    /**
+     * @return The number of ingredients in the list.
+     */
+    int size() const;
+
+    /**
+     * @return True if the list holds no ingredients, false otherwise.
+     */
+    bool empty() const;
+
+    const IngredientId& operator[](const int& index) const;
+    IngredientId& operator[](const int& index);
+
+    const IngredientId* begin() const;
+    const IngredientId* end() const;
+    IngredientId* begin();
+    IngredientId* end();
+
+    /**
+     * Appends an ingredient, moving the list to the heap if it outgrows the inline buffer.
+     * @param id The ingredient ID to append.
+     */
+    void push_back(const IngredientId& id);
+
+    /**
+     * Removes one ingredient, keeping the order of the others.
+     * @param position A pointer to the ingredient to remove.
+     * @return A pointer to the ingredient that followed the removed one.
+     */
+    IngredientId* erase(IngredientId* position);
+
+    /**
+     * Shrinks the list to its first `count` ingredients.
+     * @param count The new size, at most `size()`.
+     */
+    void truncate(const int& count);
+
+    /**
+     * @post The list is empty.
+     */
+    void clear();
+
+    /**
+     * @return True if the list stores its ingredients in a heap buffer.
+     */
+    bool isSpilled() const;
+
+    /**
+     * @return The allocated size of the heap buffer, 0 while the ingredients are stored inline.
+     */
+    size_t heapBytes() const;
+
+    /**
+     * @return The ingredient names, as string views into IngredientTable.
+     */
+    NameRange names() const;
+
+    /**
+     * @return The ingredient IDs as a vector.
+     */
+    std::vector<IngredientId> toVector() const;
+
+    bool operator==(const IngredientList& rhs) const;
+    bool operator!=(const IngredientList& rhs) const;
+
+private:
+    uint32_t size_;
+    uint32_t capacity_; // INLINE_CAPACITY while the ids are stored inline
+    union {
+        IngredientId inline_[INLINE_CAPACITY];
+        IngredientId* heap_;
+    };
+
+    /**
+     * @post The list can hold `capacity` ingredients.
+     */
+    void reserve(const uint32_t& capacity);
+
+    /**
+     * @return A pointer to the first ingredient.
+     */
+    IngredientId* data();
+    const IngredientId* data() const;
+};
+
+#endif // INGREDIENT_LIST_HPP
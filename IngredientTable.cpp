@@ -0,0 +1,292 @@
+#include "IngredientTable.hpp"
+
+#include <fstream>
+#include <mutex>
+
+IngredientTable::IngredientTable() : rules_version_(0) {
+    installDefaultRules();
+    substitutes_[0] = internAll({ "Beans", "Mushrooms" }); // MEAT
+}
+
+/**
+ * @return The process-wide ingredient table.
+ */
+IngredientTable& IngredientTable::instance() {
+    static IngredientTable table;
+    return table;
+}
+
+/**
+ * Looks up the ID of an ingredient, adding it to the table if needed.
+ * @param name The ingredient name.
+ * @return The ID of the ingredient.
+ */
+IngredientId IngredientTable::intern(const std::string& name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto found = ids_.find(name);
+        if (found != ids_.end()) {
+            return found->second;
+        }
+    }
+    return intern(std::string(name));
+}
+
+IngredientId IngredientTable::intern(std::string&& name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto found = ids_.find(name);
+        if (found != ids_.end()) {
+            return found->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto found = ids_.find(name);
+    if (found != ids_.end()) {
+        return found->second;
+    }
+    IngredientId id = IngredientId(names_.size());
+    allergens_.push_back(classify(name));
+    names_.push_back(std::move(name));
+    ids_.emplace(names_.back(), id);
+    return id;
+}
+
+/**
+ * Interns every name in a list.
+ * @param names The ingredient names.
+ * @return The IDs of the ingredients, in the same order.
+ */
+IngredientList IngredientTable::internAll(const std::vector<std::string>& names) {
+    IngredientList ids;
+    for (const std::string& name : names) {
+        ids.push_back(intern(name));
+    }
+    return ids;
+}
+
+IngredientList IngredientTable::internAll(std::vector<std::string>&& names) {
+    IngredientList ids;
+    for (std::string& name : names) {
+        ids.push_back(intern(std::move(name)));
+    }
+    return ids;
+}
+
+IngredientList IngredientTable::internAll(std::initializer_list<const char*> names) {
+    IngredientList ids;
+    for (const char* name : names) {
+        ids.push_back(intern(name));
+    }
+    return ids;
+}
+
+/**
+ * @param id An ID returned by `intern()`.
+ * @return The name of the ingredient.
+ */
+const std::string& IngredientTable::nameOf(const IngredientId& id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return names_[id];
+}
+
+/**
+ * Resolves a list of IDs back to names.
+ * @param ids The ingredient IDs.
+ * @return The names of the ingredients, in the same order.
+ */
+std::vector<std::string> IngredientTable::namesOf(const IngredientList& ids) const {
+    std::vector<std::string> names;
+    names.reserve(ids.size());
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (const IngredientId& id : ids) {
+        names.push_back(names_[id]);
+    }
+    return names;
+}
+
+/**
+ * @param id An ID returned by `intern()`.
+ * @return The allergen classes the ingredient belongs to.
+ */
+AllergenMask IngredientTable::allergensOf(const IngredientId& id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return allergens_[id];
+}
+
+/**
+ * @param ids The ingredient IDs.
+ * @return The union of the allergen classes of all the ingredients.
+ */
+AllergenMask IngredientTable::allergensOf(const IngredientList& ids) const {
+    AllergenMask mask = 0;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (const IngredientId& id : ids) {
+        mask |= allergens_[id];
+    }
+    return mask;
+}
+
+/**
+ * Looks up the allergen classes of many ingredients under a single lock.
+ * @param ids The ingredient IDs.
+ * @param count The number of IDs.
+ * @param masks Receives the allergen classes of each ID, in the same order.
+ */
+void IngredientTable::allergensOf(const IngredientId* ids, const size_t& count, AllergenMask* masks) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (size_t i = 0; i < count; i++) {
+        masks[i] = allergens_[ids[i]];
+    }
+}
+
+/**
+ * @return The number of distinct ingredients interned so far.
+ */
+size_t IngredientTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return names_.size();
+}
+
+/**
+ * @param allergen A single allergen class bit.
+ * @return The ingredients that replace ingredients of this class, in the
+ order they are used. Occurrences beyond the list are removed.
+ */
+IngredientList IngredientTable::substitutesFor(const AllergenMask& allergen) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (size_t bit = 0; bit < class_names_.size(); bit++) {
+        if (allergen == (AllergenMask(1) << bit)) {
+            return substitutes_[bit];
+        }
+    }
+    return IngredientList();
+}
+
+/**
+ * @param class_name The name of an allergen class, e.g. "NUTS".
+ * @return The bit of the class, or 0 if no rule defines it.
+ */
+AllergenMask IngredientTable::allergenClass(const std::string& class_name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (size_t bit = 0; bit < class_names_.size(); bit++) {
+        if (class_names_[bit] == class_name) {
+            return AllergenMask(1) << bit;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Replaces the dietary rules with those in a file and reclassifies every
+ * interned ingredient.
+ * @param filename The rule file to read.
+ * @return True if the file was read and all lines were valid, false otherwise.
+ */
+bool IngredientTable::loadRules(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        return false;
+    }
+    struct Rule {
+        std::string kind;
+        std::string class_name;
+        std::string ingredient;
+    };
+    std::vector<Rule> rules;
+    std::string line;
+    std::getline(file, line); // skip the header
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t first = line.find(',');
+        size_t second = first == std::string::npos ? first : line.find(',', first + 1);
+        if (second == std::string::npos) {
+            return false;
+        }
+        Rule rule = { line.substr(0, first), line.substr(first + 1, second - first - 1), line.substr(second + 1) };
+        if ((rule.kind != "CONTAINS" && rule.kind != "SUBSTITUTE") || rule.class_name.empty() || rule.ingredient.empty()) {
+            return false;
+        }
+        rules.push_back(rule);
+    }
+
+    // substitutes are ingredients themselves, so intern them before taking the lock
+    std::vector<IngredientId> substitute_ids;
+    for (const Rule& rule : rules) {
+        substitute_ids.push_back(rule.kind == "SUBSTITUTE" ? intern(rule.ingredient) : 0);
+    }
+
+    // rebuild the class table from the built-in classes so reloading does not accumulate classes
+    std::vector<std::string> class_names = { "MEAT", "DAIRY_EGG", "NUTS", "GLUTEN" };
+    std::vector<IngredientList> substitutes(class_names.size());
+    std::unordered_map<std::string, AllergenMask> compiled;
+    for (size_t i = 0; i < rules.size(); i++) {
+        size_t bit = 0;
+        while (bit < class_names.size() && class_names[bit] != rules[i].class_name) {
+            bit++;
+        }
+        if (bit == class_names.size()) {
+            if (bit == MAX_ALLERGEN_CLASSES) {
+                return false;
+            }
+            class_names.push_back(rules[i].class_name);
+            substitutes.push_back(IngredientList());
+        }
+        if (rules[i].kind == "CONTAINS") {
+            compiled[rules[i].ingredient] |= AllergenMask(1) << bit;
+        } else {
+            substitutes[bit].push_back(substitute_ids[i]);
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    rules_ = std::move(compiled);
+    class_names_ = std::move(class_names);
+    substitutes_ = std::move(substitutes);
+    rules_version_++;
+    for (IngredientId id = 0; id < names_.size(); id++) {
+        allergens_[id] = classify(names_[id]);
+    }
+    return true;
+}
+
+/**
+ * @return A number that changes whenever `loadRules()` replaces the rules.
+ */
+uint32_t IngredientTable::rulesVersion() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return rules_version_;
+}
+
+AllergenMask IngredientTable::classify(const std::string& name) const {
+    auto found = rules_.find(name);
+    return found == rules_.end() ? 0 : found->second;
+}
+
+void IngredientTable::installDefaultRules() {
+    static const char* const MEAT_NAMES[] = { "Meat", "Chicken", "Fish", "Beef", "Pork", "Lamb", "Shrimp", "Bacon" };
+    static const char* const DAIRY_EGG_NAMES[] = { "Milk", "Eggs", "Cheese", "Butter", "Cream", "Yogurt" };
+    static const char* const NUT_NAMES[] = { "Almonds", "Walnuts", "Pecans", "Hazelnuts", "Peanuts", "Cashews", "Pistachios" };
+    static const char* const GLUTEN_NAMES[] = { "Wheat", "Flour", "Bread", "Pasta", "Barley", "Rye", "Oats", "Crust" };
+
+    class_names_ = { "MEAT", "DAIRY_EGG", "NUTS", "GLUTEN" };
+    substitutes_.assign(class_names_.size(), IngredientList());
+    rules_.clear();
+    for (const char* name : MEAT_NAMES) {
+        rules_[name] |= MEAT;
+    }
+    for (const char* name : DAIRY_EGG_NAMES) {
+        rules_[name] |= DAIRY_EGG;
+    }
+    for (const char* name : NUT_NAMES) {
+        rules_[name] |= NUTS;
+    }
+    for (const char* name : GLUTEN_NAMES) {
+        rules_[name] |= GLUTEN;
+    }
+}
@@ -0,0 +1,163 @@
+#ifndef INGREDIENT_TABLE_HPP
+#define INGREDIENT_TABLE_HPP
+
+#include "IngredientList.hpp"
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Set of allergen classes, one bit per IngredientTable::Allergen.
+ */
+typedef uint32_t AllergenMask;
+
+/**
+ * @class IngredientTable
+ * @brief Process-wide symbol table mapping ingredient names to dense integer IDs.
+ *
+ * Every distinct ingredient name is stored once; dishes keep only IDs and
+ * compare them as integers. Names are resolved back for display and export.
+ * The table only grows, so an ID stays valid for the lifetime of the process.
+ *
+ * The table also holds the dietary rules: which ingredients belong to which
+ * allergen class, and what replaces ingredients of a class when a dish is
+ * adjusted. The rules are compiled into a per-ID class mask, so classifying
+ * an ingredient of a dish is a single array lookup. Built-in rules match the
+ * lists documented on the dish classes; `loadRules()` replaces them from a
+ * file such as DietaryRules.csv.
+ */
+class IngredientTable {
+public:
+    /**
+     * @enum Allergen
+     * @brief Built-in allergen classes an ingredient can belong to.
+     * Rule files may define further classes, see `allergenClass()`.
+     */
+    enum Allergen : AllergenMask { MEAT = 1 << 0, DAIRY_EGG = 1 << 1, NUTS = 1 << 2, GLUTEN = 1 << 3 };
+
+    /**
+     * @return The process-wide ingredient table.
+     */
+    static IngredientTable& instance();
+
+    /**
+     * Looks up the ID of an ingredient, adding it to the table if needed.
+     * @param name The ingredient name.
+     * @return The ID of the ingredient.
+     */
+    IngredientId intern(const std::string& name);
+    IngredientId intern(std::string&& name);
+
+    /**
+     * Interns every name in a list.
+     * @param names The ingredient names.
+     * @return The IDs of the ingredients, in the same order.
+     */
+    IngredientList internAll(const std::vector<std::string>& names);
+    IngredientList internAll(std::vector<std::string>&& names);
+    IngredientList internAll(std::initializer_list<const char*> names);
+
+    /**
+     * @param id An ID returned by `intern()`.
+     * @return The name of the ingredient.
+     */
+    const std::string& nameOf(const IngredientId& id) const;
+
+    /**
+     * Resolves a list of IDs back to names.
+     * @param ids The ingredient IDs.
+     * @return The names of the ingredients, in the same order.
+     */
+    std::vector<std::string> namesOf(const IngredientList& ids) const;
+
+    /**
+     * @param id An ID returned by `intern()`.
+     * @return The allergen classes the ingredient belongs to.
+     */
+    AllergenMask allergensOf(const IngredientId& id) const;
+
+    /**
+     * @param ids The ingredient IDs.
+     * @return The union of the allergen classes of all the ingredients.
+     */
+    AllergenMask allergensOf(const IngredientList& ids) const;
+
+    /**
+     * Looks up the allergen classes of many ingredients under a single lock.
+     * @param ids The ingredient IDs.
+     * @param count The number of IDs.
+     * @param masks Receives the allergen classes of each ID, in the same order.
+     */
+    void allergensOf(const IngredientId* ids, const size_t& count, AllergenMask* masks) const;
+
+    /**
+     * @param allergen A single allergen class bit.
+     * @return The ingredients that replace ingredients of this class, in the
+     order they are used. Occurrences beyond the list are removed.
+     */
+    IngredientList substitutesFor(const AllergenMask& allergen) const;
+
+    /**
+     * @param class_name The name of an allergen class, e.g. "NUTS".
+     * @return The bit of the class, or 0 if no rule defines it. Set it in
+     `Dish::DietaryRequest::avoid` to exclude the class.
+     */
+    AllergenMask allergenClass(const std::string& class_name) const;
+
+    /**
+     * Replaces the dietary rules with those in a file and reclassifies every
+     * interned ingredient. Dishes cache their allergen mask, so this should be
+     * called at startup, before dishes are created.
+     * Each line of the file is `CONTAINS,Class,Ingredient` or
+     * `SUBSTITUTE,Class,Ingredient`; the first line is a header and lines
+     * starting with '#' are ignored. Unknown class names define new classes,
+     * which requests exclude through `Dish::DietaryRequest::avoid`.
+     * @param filename The rule file to read.
+     * @return True if the file was read and all lines were valid, false otherwise
+     (in which case the current rules are kept).
+     */
+    bool loadRules(const std::string& filename);
+
+    /**
+     * @return A number that changes whenever `loadRules()` replaces the rules,
+     so results derived from the rules can be tagged with it.
+     */
+    uint32_t rulesVersion() const;
+
+    /**
+     * @return The number of distinct ingredients interned so far.
+     */
+    size_t size() const;
+
+private:
+    IngredientTable();
+
+    static const int MAX_ALLERGEN_CLASSES = 32;
+
+    /**
+     * @return The allergen classes of an ingredient name under the current rules.
+     */
+    AllergenMask classify(const std::string& name) const;
+
+    /**
+     * @post Installs the built-in classes and classification rules.
+     */
+    void installDefaultRules();
+
+    std::deque<std::string> names_; // deque keeps references stable as it grows
+    std::unordered_map<std::string_view, IngredientId> ids_; // keys view into names_
+    std::vector<AllergenMask> allergens_; // indexed by IngredientId
+
+    std::unordered_map<std::string, AllergenMask> rules_; // ingredient name -> classes
+    std::vector<std::string> class_names_; // index is the bit position of the class
+    std::vector<IngredientList> substitutes_; // indexed by bit position
+    uint32_t rules_version_;
+    mutable std::shared_mutex mutex_;
+};
+
+#endif // INGREDIENT_TABLE_HPP
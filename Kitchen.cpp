@@ -1,7 +1,12 @@
 #include "Kitchen.hpp"
+#include "DietaryMemo.hpp"
+#include "DishCsv.hpp"
+#include <unordered_map>
 
-Kitchen::Kitchen() : ArrayBag<Dish*>(), total_prep_time_(0), count_elaborate_(0) {
-
+Kitchen::Kitchen() : ArrayBag<Dish*>(), total_prep_time_(0), count_elaborate_(0), seen_revision_(0),
+    version_(1), event_count_(0), dropped_version_(0), change_depth_(0), changed_(false), report_version_(0) {
+    invalidateRankings();
+    counted_.reserve(DEFAULT_CAPACITY);
 }
 
 
@@ -13,53 +18,166 @@ information.
 * @post Initializes the kitchen by reading dishes from the CSV file and
 storing them as `Dish*`.
 */
-        Kitchen::Kitchen(const std::string& filename): ArrayBag<Dish*>(), total_prep_time_(0), count_elaborate_(0) {
-
+        Kitchen::Kitchen(const std::string& filename): ArrayBag<Dish*>(), total_prep_time_(0), count_elaborate_(0), seen_revision_(0),
+    version_(1), event_count_(0), dropped_version_(0), change_depth_(0), changed_(false), report_version_(0) {
+            invalidateRankings();
+            counted_.reserve(DEFAULT_CAPACITY);
+            std::ifstream file(filename);
+            std::string row;
+            std::getline(file, row); // skip the header
+            while (std::getline(file, row))
+            {
+                Dish* dish = DishCsv::parseRow(row);
+                if (dish == nullptr)
+                {
+                    continue;
+                }
+                if (newOrder(dish))
+                {
+                    adoptDish(dish);
+                }
+                else
+                {
+                    delete dish;
+                }
+            }
         };
 
 
 Kitchen::~Kitchen() {
+    for (Dish* dish : owned_)
+    {
+        delete dish;
+    }
     clear();
 }
 
+void Kitchen::adoptDish(Dish* dish)
+{
+    if (dish != nullptr)
+    {
+        owned_.insert(dish);
+    }
+}
+
+void Kitchen::releaseOwned(Dish* dish)
+{
+    if (owned_.erase(dish) != 0)
+    {
+        delete dish;
+    }
+}
+
 bool Kitchen::newOrder(Dish* new_dish)
 {
+    refresh();
+    ChangeScope scope(*this);
     if (add(new_dish))
     {
-        total_prep_time_ += new_dish->getPrepTime();
         //std::cout<< "Dish added: "<<new_dish.getName() << std::endl;
-        //if the new dish has 5 or more ingredients AND takes an hour or more to prepare, increment count_elaborate_
-        if (new_dish->getIngredients().size() >= 5 && new_dish->getPrepTime() >= 60)
-        {
-            //std::cout << "Elaborate dish added: "<<new_dish.getName() << std::endl;
-            count_elaborate_++;
-        }
+        counted_.emplace_back();
+        countDish(new_dish, counted_.back());
+        rankDishAdded(new_dish);
+        dietary_index_.add(new_dish);
+        logEvent(KitchenEvent::DISH_ADDED, new_dish);
         return true;
     }
     return false;
 }
 
 
+/**
+* Adds several dishes at once, with the same result as calling `newOrder()`
+on each in turn.
+* @param dishes The dishes to add; as with `newOrder()`, they stay the caller's.
+* @param count The number of dishes.
+* @return Whether each dish was added, by position in `dishes`.
+*/
+std::vector<bool> Kitchen::newOrders(Dish* const* dishes, const size_t& count)
+{
+    refresh();
+    ChangeScope scope(*this);
+    std::vector<bool> added(count, false);
+    int first = getCurrentSize();
+    int room = DEFAULT_CAPACITY - first;
+    if (room <= 0 || count == 0)
+    {
+        return added;
+    }
+
+    // open-addressing set of the dishes in the kitchen and those accepted so far;
+    // it never holds more than DEFAULT_CAPACITY, so it is at most half full
+    const size_t slots = 2 * DEFAULT_CAPACITY + 1;
+    const Dish* seen[slots] = {};
+    auto insert = [&seen](const Dish* dish)
+    {
+        size_t slot = (reinterpret_cast<uintptr_t>(dish) >> 4) * 0x9E3779B97F4A7C15ull % slots;
+        while (seen[slot] != nullptr)
+        {
+            if (seen[slot] == dish)
+            {
+                return false;
+            }
+            slot = slot + 1 == slots ? 0 : slot + 1;
+        }
+        seen[slot] = dish;
+        return true;
+    };
+    for (int i = 0; i < first; i++)
+    {
+        insert(items_[i]);
+    }
+    for (size_t i = 0; i < count && room > 0; i++)
+    {
+        if (dishes[i] != nullptr && insert(dishes[i]))
+        {
+            items_[item_count_++] = dishes[i];
+            added[i] = true;
+            room--;
+        }
+    }
+
+    for (int i = first; i < getCurrentSize(); i++)
+    {
+        counted_.emplace_back();
+        countDish(items_[i], counted_.back());
+        rankDishAdded(items_[i]);
+        dietary_index_.add(items_[i]);
+        logEvent(KitchenEvent::DISH_ADDED, items_[i]);
+    }
+    return added;
+}
+
+std::vector<bool> Kitchen::newOrders(const std::vector<Dish*>& dishes)
+{
+    return newOrders(dishes.data(), dishes.size());
+}
 
 bool Kitchen::serveDish(Dish* dish_to_remove)
 {
+    refresh();
+    ChangeScope scope(*this);
     if (getCurrentSize() == 0)
     {
         return false;
     }
+    int position = getIndexOf(dish_to_remove);
     if (remove(dish_to_remove))
     {
-        total_prep_time_ -= dish_to_remove->getPrepTime();
-        if (dish_to_remove->getIngredients().size() >= 5 && dish_to_remove->getPrepTime() >= 60)
-        {
-            count_elaborate_--;
-        }
+        dietary_index_.removeAt(position);
+        // the last dish took the removed one's place, as in ArrayBag::remove()
+        uncountDish(counted_[position]);
+        counted_[position] = counted_.back();
+        counted_.pop_back();
+        rankDishRemoved(dish_to_remove);
+        logEvent(KitchenEvent::DISH_REMOVED, dish_to_remove);
         return true;
     }
     return false;
 }
 int Kitchen::getPrepTimeSum() const
 {
+    refresh();
     if (getCurrentSize() == 0)
     {
         return 0;
@@ -84,6 +202,7 @@ int Kitchen::calculateAvgPrepTime() const
 }
 int Kitchen::elaborateDishCount() const
 {
+    refresh();
     if (getCurrentSize() == 0 || count_elaborate_ == 0)
     {
         return 0;
@@ -92,6 +211,7 @@ int Kitchen::elaborateDishCount() const
 }
 double Kitchen::calculateElaboratePercentage() const
 {
+    refresh();
     // //Computes the percentage of vegetarian dishes in the kitchen rounded up to 2 decimal places.
     // double elaborate_dish = count_elaborate_;
     // std::cout << elaborate_dish << std::endl;
@@ -128,6 +248,8 @@ int Kitchen::tallyCuisineTypes(const std::string& cuisine_type) const{
 }
 int Kitchen::releaseDishesBelowPrepTime(const int& prep_time)
 {
+    refresh();
+    ChangeScope scope(*this);
     int count = 0;
     int num= getCurrentSize();
     for (int i = 0; i < num; i++)
@@ -143,6 +265,8 @@ int Kitchen::releaseDishesBelowPrepTime(const int& prep_time)
 
 int Kitchen::releaseDishesOfCuisineType(const std::string& cuisine_type)
 {
+    refresh();
+    ChangeScope scope(*this);
     int count = 0;
     for (int i = 0; i < getCurrentSize(); i++)
     {
@@ -154,17 +278,552 @@ int Kitchen::releaseDishesOfCuisineType(const std::string& cuisine_type)
     }
     return count;
 }
+
+/**
+* Brings the kitchen from one menu to the next without reloading it.
+* @param edits An edit script from MenuDiff.
+* @return The number of edits applied.
+* @post The new dishes are adopted; removed and replaced dishes are deleted if adopted.
+*/
+int Kitchen::applyMenuDiff(const std::vector<MenuEdit>& edits)
+{
+    refresh();
+    ChangeScope scope(*this);
+    int applied = 0;
+    // held dishes by name, built on the first REMOVE or CHANGE
+    std::unordered_map<std::string, std::vector<Dish*>> held;
+    bool held_built = false;
+    auto take = [&](const std::string& row) -> Dish*
+    {
+        Dish* before = DishCsv::parseRow(row);
+        if (before == nullptr)
+        {
+            return nullptr;
+        }
+        if (!held_built)
+        {
+            held.reserve(getCurrentSize());
+            for (int i = 0; i < getCurrentSize(); i++)
+            {
+                held[items_[i]->getName()].push_back(items_[i]);
+            }
+            held_built = true;
+        }
+        Dish* found = nullptr;
+        auto candidates = held.find(before->getName());
+        if (candidates != held.end())
+        {
+            std::vector<Dish*>& dishes = candidates->second;
+            for (size_t i = 0; i < dishes.size(); i++)
+            {
+                if (*dishes[i] == *before)
+                {
+                    found = dishes[i];
+                    dishes.erase(dishes.begin() + i);
+                    break;
+                }
+            }
+        }
+        delete before;
+        return found;
+    };
+
+    // removals first, so their room is free for the additions
+    for (const MenuEdit& edit : edits)
+    {
+        if (edit.kind != MenuEdit::REMOVE)
+        {
+            continue;
+        }
+        Dish* dish = take(edit.before);
+        if (dish != nullptr && serveDish(dish))
+        {
+            releaseOwned(dish);
+            applied++;
+        }
+    }
+    for (const MenuEdit& edit : edits)
+    {
+        if (edit.kind != MenuEdit::CHANGE)
+        {
+            continue;
+        }
+        Dish* dish = take(edit.before);
+        if (dish == nullptr)
+        {
+            continue;
+        }
+        Dish* after = DishCsv::parseRow(edit.after);
+        if (after == nullptr)
+        {
+            continue;
+        }
+        releaseOwned(replaceDish(getIndexOf(dish), after));
+        adoptDish(after);
+        applied++;
+    }
+    for (const MenuEdit& edit : edits)
+    {
+        if (edit.kind != MenuEdit::ADD)
+        {
+            continue;
+        }
+        Dish* after = DishCsv::parseRow(edit.after);
+        if (after != nullptr && newOrder(after))
+        {
+            adoptDish(after);
+            applied++;
+        }
+        else
+        {
+            delete after;
+        }
+    }
+    return applied;
+}
+
 void Kitchen::kitchenReport() const
 {
-    std::cout << "ITALIAN: " << tallyCuisineTypes("ITALIAN") << std::endl;
-    std::cout << "MEXICAN: " << tallyCuisineTypes("MEXICAN") << std::endl;
-    std::cout << "CHINESE: " << tallyCuisineTypes("CHINESE") << std::endl;
-    std::cout << "INDIAN: " << tallyCuisineTypes("INDIAN") << std::endl;
-    std::cout << "AMERICAN: " << tallyCuisineTypes("AMERICAN") << std::endl;
-    std::cout << "FRENCH: " << tallyCuisineTypes("FRENCH") << std::endl;
-    std::cout << "OTHER: " << tallyCuisineTypes("OTHER") << std::endl<<std::endl;
-    std::cout << "AVERAGE PREP TIME: " << calculateAvgPrepTime() << std::endl;
-    std::cout << "ELABORATE DISHES: " << calculateElaboratePercentage() << "%" << std::endl;
+    refresh();
+    std::vector<std::string> lines;
+    reportLines(lines);
+    for (const std::string& line : lines)
+    {
+        std::cout << line << std::endl;
+    }
+}
+
+void Kitchen::reportLines(std::vector<std::string>& lines) const
+{
+    static const char* const CUISINES[] = { "ITALIAN", "MEXICAN", "CHINESE", "INDIAN", "AMERICAN", "FRENCH", "OTHER" };
+    for (const char* cuisine : CUISINES)
+    {
+        lines.push_back(std::string(cuisine) + ": " + std::to_string(tallyCuisineTypes(cuisine)));
+    }
+    lines.push_back("");
+    lines.push_back("AVERAGE PREP TIME: " + std::to_string(calculateAvgPrepTime()));
+    std::ostringstream elaborate;
+    elaborate << "ELABORATE DISHES: " << calculateElaboratePercentage() << "%";
+    lines.push_back(elaborate.str());
+    std::vector<long long> prep_times;
+    std::vector<long long> prices;
+    sortedValues(prep_times, prices);
+    lines.push_back(distributionLine("PREP TIME", prep_times, false));
+    lines.push_back(distributionLine("PRICE", prices, true));
+}
+
+/**
+* Prints the lines of `kitchenReport()` that changed after a version.
+* @param since A version returned by an earlier call, or 0 for the full report.
+* @return The current version, to pass to the next call.
+*/
+uint64_t Kitchen::kitchenReportSince(const uint64_t& since) const
+{
+    refresh();
+    if (report_version_ != version_)
+    {
+        std::vector<std::string> lines;
+        reportLines(lines);
+        report_line_versions_.resize(lines.size(), version_);
+        for (size_t i = 0; i < lines.size(); i++)
+        {
+            if (i >= report_lines_.size() || lines[i] != report_lines_[i])
+            {
+                report_line_versions_[i] = version_;
+            }
+        }
+        report_lines_.swap(lines);
+        report_version_ = version_;
+    }
+    for (size_t i = 0; i < report_lines_.size(); i++)
+    {
+        if (since == 0 || report_line_versions_[i] > since)
+        {
+            std::cout << report_lines_[i] << std::endl;
+        }
+    }
+    return version_;
+}
+
+/**
+* @return A number that grows with every operation that changes the kitchen.
+*/
+uint64_t Kitchen::version() const
+{
+    refresh();
+    return version_;
+}
+
+/**
+* Registers an observer to be notified after every change.
+* @param observer The observer; it must be unsubscribed before it is destroyed.
+*/
+void Kitchen::subscribe(KitchenObserver* observer)
+{
+    observers_.push_back(observer);
+}
+
+/**
+* @param observer A subscribed observer.
+* @post The observer is no longer notified.
+*/
+void Kitchen::unsubscribe(KitchenObserver* observer)
+{
+    observers_.erase(std::remove(observers_.begin(), observers_.end(), observer), observers_.end());
+}
+
+/**
+* Collects the change events newer than a version from the change log.
+* @param since A version returned by `version()`.
+* @param events Receives the events with a later version, oldest first.
+* @return False if some of those events were already dropped from the log.
+*/
+bool Kitchen::eventsSince(const uint64_t& since, std::vector<KitchenEvent>& events) const
+{
+    refresh();
+    uint64_t retained = std::min<uint64_t>(event_count_, EVENT_LOG_CAPACITY);
+    for (uint64_t n = event_count_ - retained; n < event_count_; n++)
+    {
+        const KitchenEvent& event = event_log_[n % EVENT_LOG_CAPACITY];
+        if (event.version > since)
+        {
+            events.push_back(event);
+        }
+    }
+    return since >= dropped_version_;
+}
+
+Kitchen::ChangeScope::ChangeScope(const Kitchen& kitchen) : kitchen_(kitchen)
+{
+    kitchen_.change_depth_++;
+}
+
+Kitchen::ChangeScope::~ChangeScope()
+{
+    if (--kitchen_.change_depth_ > 0 || !kitchen_.changed_)
+    {
+        return;
+    }
+    kitchen_.changed_ = false;
+    for (KitchenObserver* observer : kitchen_.observers_)
+    {
+        observer->kitchenChanged(kitchen_, kitchen_.version_);
+    }
+}
+
+void Kitchen::logEvent(const KitchenEvent::Kind& kind, const Dish* dish) const
+{
+    if (!changed_)
+    {
+        changed_ = true;
+        version_++;
+    }
+    if (event_log_.size() < EVENT_LOG_CAPACITY)
+    {
+        event_log_.emplace_back();
+    }
+    KitchenEvent& event = event_log_[event_count_ % EVENT_LOG_CAPACITY];
+    if (event_count_ >= EVENT_LOG_CAPACITY)
+    {
+        dropped_version_ = event.version;
+    }
+    event_count_++;
+    event.kind = kind;
+    event.version = version_;
+    event.dish_name.assign(dish == nullptr ? "" : dish->getName());
+    event.cuisine_type = dish == nullptr ? Dish::OTHER : dish->getCuisineTypeEnum();
+    event.prep_time = dish == nullptr ? 0 : dish->getPrepTime();
+    event.dish_count = dish == nullptr ? getCurrentSize() : 1;
+}
+
+//a dish is elaborate if it has 5 or more ingredients AND takes an hour or more to prepare
+bool Kitchen::isElaborate(const Dish* dish)
+{
+    return dish->ingredientCount() >= 5 && dish->getPrepTime() >= 60;
+}
+
+void Kitchen::countDish(const Dish* dish, CountedDish& counted) const
+{
+    counted.revision = dish->revision();
+    counted.prep_time = dish->getPrepTime();
+    counted.price = dish->getPrice();
+    counted.cuisine_type = dish->getCuisineTypeEnum();
+    counted.elaborate = isElaborate(dish);
+    total_prep_time_ += counted.prep_time;
+    if (counted.elaborate)
+    {
+        count_elaborate_++;
+    }
+    total_revenue_ += counted.price;
+    cuisine_revenue_[counted.cuisine_type] += counted.price;
+}
+
+void Kitchen::uncountDish(const CountedDish& counted) const
+{
+    total_prep_time_ -= counted.prep_time;
+    if (counted.elaborate)
+    {
+        count_elaborate_--;
+    }
+    total_revenue_ -= counted.price;
+    cuisine_revenue_[counted.cuisine_type] -= counted.price;
+}
+
+void Kitchen::refresh() const
+{
+    uint64_t latest = Dish::latestRevision();
+    if (latest == seen_revision_)
+    {
+        return;
+    }
+    seen_revision_ = latest;
+    ChangeScope scope(*this);
+    for (int i = 0; i < getCurrentSize(); i++)
+    {
+        const Dish* dish = items_[i];
+        if (dish->revision() == counted_[i].revision)
+        {
+            continue;
+        }
+        uncountDish(counted_[i]);
+        countDish(dish, counted_[i]);
+        dietary_index_.update(i, dish);
+        // drop the caches it was ranked in, then rank it anew in the others
+        rankDishRemoved(items_[i]);
+        rankDishAdded(items_[i]);
+        logEvent(KitchenEvent::DISH_CHANGED, dish);
+    }
+}
+
+Dish* Kitchen::replaceDish(const int& position, Dish* dish)
+{
+    Dish* replaced = items_[position];
+    uncountDish(counted_[position]);
+    rankDishRemoved(replaced);
+    items_[position] = dish;
+    countDish(dish, counted_[position]);
+    rankDishAdded(dish);
+    dietary_index_.update(position, dish);
+    logEvent(KitchenEvent::DISH_REMOVED, replaced);
+    logEvent(KitchenEvent::DISH_ADDED, dish);
+    return replaced;
+}
+
+/**
+* Finds the dishes that meet a dietary request.
+* @param request The properties to require: vegetarian, vegan, gluten-free,
+nut-free and low-sugar, and no allergen class in `avoid`. `low_sodium` is ignored.
+* @param include_adjustable If true, dishes that would meet the request
+after their `dietaryAccommodations()` also match.
+* @return The matching dishes.
+*/
+std::vector<Dish*> Kitchen::filterDishes(const Dish::DietaryRequest& request, const bool& include_adjustable) const
+{
+    refresh();
+    // the index knows the built-in properties; classes in `avoid` are checked per dish
+    Dish::DietaryRequest avoid_only = {};
+    avoid_only.avoid = request.avoid;
+    std::vector<Dish*> dishes;
+    for (int position : dietary_index_.match(request, include_adjustable))
+    {
+        const Dish* dish = items_[position];
+        if (request.avoid != 0 && (dish->dietaryAllergens(nullptr) & request.avoid) != 0
+            && (!include_adjustable || (dish->dietaryAllergens(&avoid_only) & request.avoid) != 0))
+        {
+            continue;
+        }
+        dishes.push_back(items_[position]);
+    }
+    return dishes;
+}
+
+/**
+* Measures the memory the kitchen holds, including the dishes it holds.
+The dish objects themselves are counted only if adopted, see `adoptDish()`.
+* @return The bytes by category, as sized by the allocator; see MemoryUsage.
+*/
+MemoryUsage Kitchen::memoryUsage() const
+{
+    MemoryUsage usage;
+    usage.kitchen = sizeof(Kitchen);
+    for (int i = 0; i < getCurrentSize(); i++)
+    {
+        if (owned_.count(items_[i]) != 0)
+        {
+            // only adopted dishes are known to be heap blocks
+            usage.dish_objects += MemoryUsage::allocatedSize(items_[i]);
+        }
+        items_[i]->addMemoryUsage(usage);
+    }
+    for (int key = 0; key < RANK_KEY_COUNT; key++)
+    {
+        usage.caches += MemoryUsage::allocatedSize(top_cache_[key]);
+    }
+    usage.indexes += MemoryUsage::allocatedSize(dishes);
+    usage.indexes += dietary_index_.heapBytes();
+    usage.indexes += MemoryUsage::allocatedSize(event_log_) + MemoryUsage::allocatedSize(observers_);
+    for (const KitchenEvent& event : event_log_)
+    {
+        usage.indexes += MemoryUsage::allocatedSize(event.dish_name);
+    }
+    usage.indexes += MemoryUsage::allocatedSize(report_lines_) + MemoryUsage::allocatedSize(report_line_versions_);
+    for (const std::string& line : report_lines_)
+    {
+        usage.indexes += MemoryUsage::allocatedSize(line);
+    }
+    return usage;
+}
+
+void Kitchen::sortedValues(std::vector<long long>& prep_times, std::vector<long long>& prices) const
+{
+    prep_times.reserve(getCurrentSize());
+    prices.reserve(getCurrentSize());
+    for (int i = 0; i < getCurrentSize(); i++)
+    {
+        prep_times.push_back(items_[i]->getPrepTime());
+        prices.push_back(items_[i]->getPrice().getCents());
+    }
+    std::sort(prep_times.begin(), prep_times.end());
+    std::sort(prices.begin(), prices.end());
+}
+
+void Kitchen::distribution(const std::vector<long long>& sorted, long long (&values)[5])
+{
+    static const double PERCENTILES[] = { 0, 50, 90, 99, 100 };
+    long long count = (long long)sorted.size();
+    for (int i = 0; i < 5; i++)
+    {
+        // nearest rank, 1-based
+        long long rank = (long long)(PERCENTILES[i] / 100.0 * count + 0.5);
+        rank = std::max(1LL, std::min(rank, count));
+        values[i] = count == 0 ? 0 : sorted[rank - 1];
+    }
+}
+
+/**
+* Exports the menu and the data of `kitchenReport()`.
+* @param format The encoding to use.
+* @param buffer The buffer to append to.
+*/
+void Kitchen::serialize(const Format& format, std::string& buffer) const
+{
+    refresh();
+    static const char* const DISTRIBUTION_NAMES[] = { "min", "p50", "p90", "p99", "max" };
+    SerialWriter writer(buffer);
+    int cuisine_counts[CUISINE_TYPE_COUNT] = {};
+    for (int i = 0; i < getCurrentSize(); i++)
+    {
+        cuisine_counts[items_[i]->getCuisineTypeEnum()]++;
+    }
+    std::vector<long long> prep_time_values;
+    std::vector<long long> price_values;
+    sortedValues(prep_time_values, price_values);
+    long long prep_times[5];
+    long long prices[5];
+    distribution(prep_time_values, prep_times);
+    distribution(price_values, prices);
+
+    switch (format)
+    {
+        case JSON:
+            writer.text("{\"dishes\":[");
+            for (int i = 0; i < getCurrentSize(); i++)
+            {
+                if (i != 0)
+                {
+                    writer.character(',');
+                }
+                items_[i]->serialize(format, buffer);
+            }
+            writer.text("],\"report\":{\"cuisine_counts\":{");
+            for (int c = 0; c < CUISINE_TYPE_COUNT; c++)
+            {
+                if (c != 0)
+                {
+                    writer.character(',');
+                }
+                writer.jsonString(Dish::CUISINE_TYPE_NAMES[c]);
+                writer.character(':');
+                writer.integer(cuisine_counts[c]);
+            }
+            writer.text("},\"average_prep_time\":");
+            writer.integer(calculateAvgPrepTime());
+            writer.text(",\"elaborate_percentage\":");
+            writer.decimal(calculateElaboratePercentage());
+            writer.text(",\"prep_time\":{");
+            for (int i = 0; i < 5; i++)
+            {
+                writer.text(i == 0 ? "\"" : ",\"");
+                writer.text(DISTRIBUTION_NAMES[i]);
+                writer.text("\":");
+                writer.integer(prep_times[i]);
+            }
+            writer.text("},\"price\":{");
+            for (int i = 0; i < 5; i++)
+            {
+                writer.text(i == 0 ? "\"" : ",\"");
+                writer.text(DISTRIBUTION_NAMES[i]);
+                writer.text("\":");
+                writer.money(Money::fromCents(prices[i]));
+            }
+            writer.text("},\"total_revenue\":");
+            writer.money(total_revenue_);
+            writer.text("}}");
+            break;
+        case CSV:
+            writer.text("DishType,Name,Ingredients,PreparationTime,Price,CuisineType,AdditionalAttributes\n");
+            for (int i = 0; i < getCurrentSize(); i++)
+            {
+                items_[i]->serialize(format, buffer);
+            }
+            break;
+        case BINARY:
+            writer.varint(getCurrentSize());
+            for (int i = 0; i < getCurrentSize(); i++)
+            {
+                items_[i]->serialize(format, buffer);
+            }
+            for (int c = 0; c < CUISINE_TYPE_COUNT; c++)
+            {
+                writer.varint(cuisine_counts[c]);
+            }
+            writer.signedVarint(calculateAvgPrepTime());
+            writer.signedVarint(llround(calculateElaboratePercentage() * 100));
+            for (int i = 0; i < 5; i++)
+            {
+                writer.signedVarint(prep_times[i]);
+            }
+            for (int i = 0; i < 5; i++)
+            {
+                writer.signedVarint(prices[i]);
+            }
+            writer.signedVarint(total_revenue_.getCents());
+            break;
+    }
+}
+
+std::string Kitchen::distributionLine(const std::string& label, const std::vector<long long>& sorted, const bool& as_price)
+{
+    long long values[5];
+    distribution(sorted, values);
+    std::ostringstream line;
+    line << label << " (MIN/P50/P90/P99/MAX): ";
+    for (int i = 0; i < 5; i++)
+    {
+        if (i != 0)
+        {
+            line << " / ";
+        }
+        if (as_price)
+        {
+            line << "$" << Money::fromCents(values[i]);
+        }
+        else
+        {
+            line << values[i];
+        }
+    }
+    return line.str();
 }
 
 
@@ -176,12 +835,59 @@ void Kitchen::kitchenReport() const
 accommodation.
 * @param request A DietaryRequest structure specifying the dietary
 accommodations.
-* @post Calls the `dietaryAccommodations()` method on each dish in the
-kitchen to adjust them accordingly.
+* @post Adjusts each dish as its `dietaryAccommodations()` method would.
+Results already in the DietaryMemo are reused; the ingredients of the
+other dishes are transformed together in one flat buffer by DietaryKernel.
+Each result is handed back with `applyDietaryResult()`.
 */
 
 void Kitchen::dietaryAdjustment(const Dish::DietaryRequest& request) {
+    refresh();
+    ChangeScope scope(*this);
+    DietaryMemo& memo = DietaryMemo::instance();
+    std::vector<IngredientList> results(getCurrentSize());
 
+    // dishes whose result is not memoized are transformed together in one flat buffer
+    std::vector<int> misses;
+    std::vector<DietaryPlan> plans;
+    std::vector<IngredientId> ingredients;
+    std::vector<size_t> offsets;
+    offsets.push_back(0);
+    for (int i = 0; i < getCurrentSize(); i++)
+    {
+        const IngredientList& ids = items_[i]->getIngredientIds();
+        DietaryPlan plan = items_[i]->dietaryPlan(request);
+        if (!plan.changesIngredients() || memo.find(ids, plan, results[i]))
+        {
+            continue;
+        }
+        misses.push_back(i);
+        plans.push_back(plan);
+        ingredients.insert(ingredients.end(), ids.begin(), ids.end());
+        offsets.push_back(ingredients.size());
+    }
+    DietaryKernel::apply(plans, ingredients, offsets);
+    for (size_t j = 0; j < misses.size(); j++)
+    {
+        int i = misses[j];
+        results[i] = IngredientList(ingredients.data() + offsets[j], ingredients.data() + offsets[j + 1]);
+        memo.store(items_[i]->getIngredientIds(), plans[j], results[i]);
+    }
+
+    for (int i = 0; i < getCurrentSize(); i++)
+    {
+        Dish* dish = items_[i];
+        uncountDish(counted_[i]);
+        dish->applyDietaryResult(request, std::move(results[i]));
+        countDish(dish, counted_[i]);
+        dietary_index_.update(i, dish);
+    }
+    // ingredient counts may change, so cached rankings can no longer be trusted
+    invalidateRankings();
+    if (!isEmpty())
+    {
+        logEvent(KitchenEvent::DISHES_ADJUSTED, nullptr);
+    }
 }
 
 
@@ -190,5 +896,156 @@ void Kitchen::dietaryAdjustment(const Dish::DietaryRequest& request) {
 * @post Calls the `display()` method of each dish.
 */
 void Kitchen::displayMenu() {
+    for (int i = 0; i < getCurrentSize(); i++)
+    {
+        items_[i]->display();
+    }
+}
+
+
+
+/**
+* Finds the k highest-ranked dishes by the given key.
+* @param key The RankKey to rank dishes by (PRICE, PREP_TIME or INGREDIENT_COUNT).
+* @param k The maximum number of dishes to return.
+* @param cuisine_type If non-empty, only dishes of this cuisine type are considered.
+* @return Up to k dishes ordered from highest to lowest by key.
+*/
+std::vector<Dish*> Kitchen::topK(const RankKey& key, const int& k, const std::string& cuisine_type) const
+{
+    refresh();
+    if (k <= 0)
+    {
+        return {};
+    }
+    if (!cuisine_type.empty())
+    {
+        return selectTopK(key, k, cuisine_type);
+    }
+    // a cache built for at least k dishes (or holding every dish) answers in O(k)
+    if (!top_cache_valid_[key] || top_cache_k_[key] < k)
+    {
+        top_cache_[key] = selectTopK(key, k, cuisine_type);
+        top_cache_k_[key] = k;
+        top_cache_valid_[key] = true;
+    }
+    int count = std::min(k, int(top_cache_[key].size()));
+    return std::vector<Dish*>(top_cache_[key].begin(), top_cache_[key].begin() + count);
+}
+
+double Kitchen::rankValue(const Dish* dish, const RankKey& key)
+{
+    switch (key)
+    {
+        case PRICE: return double(dish->getPrice().getCents());
+        case PREP_TIME: return dish->getPrepTime();
+        case INGREDIENT_COUNT: return dish->ingredientCount();
+    }
+    return 0;
+}
+
+std::vector<Dish*> Kitchen::selectTopK(const RankKey& key, const int& k, const std::string& cuisine_type) const
+{
+    // min-heap of the best k seen so far, so the weakest candidate sits on top
+    auto ranks_higher = [&key](const Dish* lhs, const Dish* rhs) {
+        return rankValue(lhs, key) > rankValue(rhs, key);
+    };
+    std::vector<Dish*> heap;
+    heap.reserve(std::min(k, getCurrentSize()));
+    for (int i = 0; i < getCurrentSize(); i++)
+    {
+        if (!cuisine_type.empty() && items_[i]->getCuisineType() != cuisine_type)
+        {
+            continue;
+        }
+        if (int(heap.size()) < k)
+        {
+            heap.push_back(items_[i]);
+            std::push_heap(heap.begin(), heap.end(), ranks_higher);
+        }
+        else if (ranks_higher(items_[i], heap.front()))
+        {
+            std::pop_heap(heap.begin(), heap.end(), ranks_higher);
+            heap.back() = items_[i];
+            std::push_heap(heap.begin(), heap.end(), ranks_higher);
+        }
+    }
+    std::sort_heap(heap.begin(), heap.end(), ranks_higher);
+    return heap;
+}
+
+void Kitchen::rankDishAdded(Dish* dish) const
+{
+    for (int key = 0; key < RANK_KEY_COUNT; key++)
+    {
+        if (!top_cache_valid_[key])
+        {
+            continue;
+        }
+        std::vector<Dish*>& cache = top_cache_[key];
+        RankKey rank_key = RankKey(key);
+        double value = rankValue(dish, rank_key);
+        if (int(cache.size()) == top_cache_k_[key])
+        {
+            if (value <= rankValue(cache.back(), rank_key))
+            {
+                continue;
+            }
+            cache.pop_back();
+        }
+        auto position = std::upper_bound(cache.begin(), cache.end(), value,
+            [&rank_key](double lhs, const Dish* rhs) { return lhs > rankValue(rhs, rank_key); });
+        cache.insert(position, dish);
+    }
+}
+
+void Kitchen::rankDishRemoved(Dish* dish) const
+{
+    for (int key = 0; key < RANK_KEY_COUNT; key++)
+    {
+        // the replacement for a cached dish is unknown, so rebuild on the next query
+        if (top_cache_valid_[key] && std::find(top_cache_[key].begin(), top_cache_[key].end(), dish) != top_cache_[key].end())
+        {
+            top_cache_valid_[key] = false;
+        }
+    }
+}
+
+void Kitchen::invalidateRankings()
+{
+    for (int key = 0; key < RANK_KEY_COUNT; key++)
+    {
+        top_cache_[key].clear();
+        top_cache_k_[key] = 0;
+        top_cache_valid_[key] = false;
+    }
+}
+
+Money Kitchen::totalRevenue() const
+{
+    refresh();
+    return total_revenue_;
+}
 
-}
\ No newline at end of file
+Money Kitchen::averagePrice() const
+{
+    refresh();
+    if (getCurrentSize() == 0)
+    {
+        return Money();
+    }
+    return total_revenue_.dividedBy(getCurrentSize());
+}
+
+Money Kitchen::cuisineRevenue(const std::string& cuisine_type) const
+{
+    refresh();
+    for (int i = 0; i < CUISINE_TYPE_COUNT; i++)
+    {
+        if (Dish::cuisineTypeToString(Dish::CuisineType(i)) == cuisine_type)
+        {
+            return cuisine_revenue_[i];
+        }
+    }
+    return Money();
+}
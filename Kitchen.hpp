@@ -2,18 +2,30 @@
 #define KITCHEN_HPP
 
 #include "ArrayBag.hpp"
+#include "DietaryIndex.hpp"
 #include "Dish.hpp"
+#include "KitchenObserver.hpp"
+#include "MemoryUsage.hpp"
+#include "MenuDiff.hpp"
 // for round
 #include <cmath>
 // for reading file
 #include <fstream>
+#include <unordered_set>
 #include <vector>
+// for heap based top-k selection
+#include <algorithm>
 
 
 
 
-class Kitchen : public ArrayBag<Dish*> {
+class Kitchen : public ArrayBag<Dish*>, public Serializable {
     public:
+        /**
+        * Keys by which dishes can be ranked in topK().
+        */
+        enum RankKey { PRICE, PREP_TIME, INGREDIENT_COUNT };
+
         Kitchen();
 
 
@@ -24,23 +36,28 @@ class Kitchen : public ArrayBag<Dish*> {
 information.
 * @pre The CSV file must be properly formatted.
 * @post Initializes the kitchen by reading dishes from the CSV file and
-storing them as `Dish*`.
+storing them as `Dish*`. The kitchen adopts these dishes (see `adoptDish()`).
 */
         Kitchen(const std::string& filename);
         /**
 * Destructor.
-* @post Deallocates all dynamically allocated dishes to prevent memory
-leaks.
+* @post Deallocates the dishes the kitchen adopted to prevent memory
+leaks. Other dishes belong to whoever ordered them and are left alone.
 */      
         ~Kitchen();
 
+        Kitchen(const Kitchen&) = delete;
+        Kitchen& operator=(const Kitchen&) = delete;
+
         /**
 * Adjusts all dishes in the kitchen based on the specified dietary
 accommodation.
 * @param request A DietaryRequest structure specifying the dietary
 accommodations.
-* @post Calls the `dietaryAccommodations()` method on each dish in the
-kitchen to adjust them accordingly.
+* @post Adjusts each dish as its `dietaryAccommodations()` method would.
+Results already in the DietaryMemo are reused; the ingredients of the
+other dishes are transformed together in one flat buffer by DietaryKernel.
+Each result is handed back with `applyDietaryResult()`.
 */
         void dietaryAdjustment(const Dish::DietaryRequest& request);
 
@@ -49,7 +66,29 @@ kitchen to adjust them accordingly.
 * @post Calls the `display()` method of each dish.
 */
         void displayMenu();
+
+/**
+* Adds a dish to the kitchen. The kitchen does not take ownership: serving
+or releasing the dish hands it back, and the caller must keep it alive while
+the kitchen holds it, unless the kitchen adopts it with `adoptDish()`.
+* @param new_dish The dish to add.
+* @return False if the dish is nullptr, already in the kitchen, or there is
+no room for it.
+*/
         bool newOrder( Dish* new_dish);
+
+/**
+* Adds several dishes at once, with the same result as calling `newOrder()`
+on each in turn: a dish is rejected if it is nullptr, already in the kitchen,
+earlier in the batch, or there is no room left for it.
+* Capacity and duplicates are checked in one hashed pass instead of a
+linear `contains()` per dish.
+* @param dishes The dishes to add; as with `newOrder()`, they stay the caller's.
+* @param count The number of dishes.
+* @return Whether each dish was added, by position in `dishes`.
+*/
+        std::vector<bool> newOrders(Dish* const* dishes, const size_t& count);
+        std::vector<bool> newOrders(const std::vector<Dish*>& dishes);
         bool serveDish(Dish* dish_to_remove);
         int getPrepTimeSum() const;
         int calculateAvgPrepTime() const;
@@ -60,10 +99,302 @@ kitchen to adjust them accordingly.
         int releaseDishesOfCuisineType(const std::string& cuisine_type);
         void kitchenReport() const;
 
+        /**
+        * Makes the kitchen responsible for deleting a dish it allocated on
+        its caller's behalf, e.g. one parsed from a menu file. An adopted dish
+        is deleted when `applyMenuDiff()` removes or replaces it, or else when
+        the kitchen is destroyed, even if it was served before then.
+        * @param dish A dish allocated with new, usually one just added with `newOrder()`.
+        */
+        void adoptDish(Dish* dish);
+
+        /**
+        * Brings the kitchen from one menu to the next without reloading it.
+        * Removals are applied first, then changes, then additions, all as one
+        change with one version (see `version()`). A REMOVE or CHANGE applies to
+        a held dish equal to its `before` row by `Dish::operator==`, so dishes
+        altered by `dietaryAdjustment()` are still found; a changed dish is
+        replaced in its place. Dishes not named in the script are untouched.
+        * @param edits An edit script from MenuDiff.
+        * @return The number of edits applied. An edit is skipped if its dish is
+        not in the kitchen, a row does not parse, or there is no room for an ADD.
+        * @post The new dishes are adopted (see `adoptDish()`); removed and
+        replaced dishes are deleted if the kitchen adopted them.
+        */
+        int applyMenuDiff(const std::vector<MenuEdit>& edits);
+
+        /**
+        * Finds the k highest-ranked dishes by the given key.
+        * @param key The RankKey to rank dishes by (PRICE, PREP_TIME or INGREDIENT_COUNT).
+        * @param k The maximum number of dishes to return.
+        * @param cuisine_type If non-empty, only dishes of this cuisine type are considered.
+        * @return Up to k dishes ordered from highest to lowest by key.
+        * @post Unfiltered results are cached per key and kept up to date by
+        `newOrder()` and `serveDish()`, and for dishes changed in place by the
+        next call to the kitchen (see `version()`), so repeated queries on an
+        unchanged kitchen cost O(k).
+        */
+        std::vector<Dish*> topK(const RankKey& key, const int& k, const std::string& cuisine_type = "") const;
+
+        /**
+        * @return The exact sum of the prices of all dishes in the kitchen.
+        * @post The totals are counted when a dish is added and taken back when
+        it is removed. Held dishes changed in place since, e.g. with
+        `Dish::setPrice()`, are recounted first; see `version()`. Change a
+        held dish with `applyMenuDiff()`, or serve it, change it and order it again.
+        */
+        Money totalRevenue() const;
+
+        /**
+        * @return The average price of the dishes in the kitchen, rounded to the cent, or $0.00 if empty.
+        */
+        Money averagePrice() const;
+
+        /**
+        * @param cuisine_type The cuisine type in string form, as returned by `Dish::getCuisineType()`.
+        * @return The exact sum of the prices of all dishes of the given cuisine type.
+        */
+        Money cuisineRevenue(const std::string& cuisine_type) const;
+
+        /**
+        * Finds the dishes that meet a dietary request.
+        * @param request The properties to require: vegetarian, vegan, gluten-free,
+        nut-free and low-sugar, and no allergen class in `avoid`. `low_sodium` is ignored.
+        * @param include_adjustable If true, dishes that would meet the request
+        after their `dietaryAccommodations()` also match.
+        * @return The matching dishes.
+        * @post Answered from a bitmap index kept current by `newOrder()`,
+        `serveDish()` and `dietaryAdjustment()`, and for dishes changed in place
+        by the next call to the kitchen (see `version()`). A property is judged from the
+        dish's ingredients and its own flags such as `Appetizer::isVegetarian()`,
+        and each required property is checked on its own.
+        */
+        std::vector<Dish*> filterDishes(const Dish::DietaryRequest& request, const bool& include_adjustable) const;
+
+        /**
+        * Measures the memory the kitchen holds, including the dishes it holds.
+        The dish objects themselves are counted only if adopted, see `adoptDish()`.
+        * @return The bytes by category, as sized by the allocator; see MemoryUsage.
+        */
+        MemoryUsage memoryUsage() const;
+
+        /**
+        * @return A number that grows with every operation that changes the
+        kitchen; a new kitchen is at version 1. A held dish changed in place,
+        e.g. with `Dish::setPrice()`, is a change too: the next call to the
+        kitchen recounts it and logs a DISH_CHANGED event under a new version.
+        */
+        uint64_t version() const;
+
+        /**
+        * Registers an observer to be notified after every change.
+        * @param observer The observer; it must be unsubscribed before it is destroyed.
+        */
+        void subscribe(KitchenObserver* observer);
+
+        /**
+        * @param observer A subscribed observer.
+        * @post The observer is no longer notified.
+        */
+        void unsubscribe(KitchenObserver* observer);
+
+        /**
+        * Collects the change events newer than a version from the change log,
+        which keeps the last EVENT_LOG_CAPACITY events.
+        * @param since A version returned by `version()`.
+        * @param events Receives the events with a later version, oldest first.
+        * @return False if some of those events were already dropped from the log;
+        the caller should then start over from a full report.
+        */
+        bool eventsSince(const uint64_t& since, std::vector<KitchenEvent>& events) const;
+
+        /**
+        * Prints the lines of `kitchenReport()` that changed after a version.
+        * Costs nothing beyond a comparison if the kitchen has not changed since
+        the last call.
+        * @param since A version returned by an earlier call, or 0 for the full report.
+        * @return The current version, to pass to the next call.
+        */
+        uint64_t kitchenReportSince(const uint64_t& since) const;
+
+        /**
+        * Exports the menu and the data of `kitchenReport()`.
+        * JSON: {"dishes":[...],"report":{...}}.
+        * CSV: the menu as a Dishes.csv file, header included; CSV has no room for the report.
+        * BINARY: the dish count, the dish records, then the report as varints
+        (cuisine counts, average prep time, elaborate percentage in hundredths,
+        prep time and price distributions, total revenue in cents).
+        * @param format The encoding to use.
+        * @param buffer The buffer to append to.
+        */
+        void serialize(const Format& format, std::string& buffer) const override;
+
     private:
-        int total_prep_time_;
+        static const int RANK_KEY_COUNT = 3;
+        static const int CUISINE_TYPE_COUNT = Dish::OTHER + 1;
+
+        // The running totals and indexes below count each held dish as it was
+        // when last counted. They are mutable because a dish changed in place
+        // is recounted by the next call, const or not; see refresh().
+        mutable int total_prep_time_;
         std::vector<Dish*> dishes;        
-        int count_elaborate_;
+        mutable int count_elaborate_;
+
+        // Bounded top-k cache per RankKey, sorted from highest to lowest.
+        mutable std::vector<Dish*> top_cache_[RANK_KEY_COUNT];
+        mutable int top_cache_k_[RANK_KEY_COUNT];
+        mutable bool top_cache_valid_[RANK_KEY_COUNT];
+
+        // Exact revenue totals, kept current by newOrder() and serveDish().
+        mutable Money total_revenue_;
+        mutable Money cuisine_revenue_[CUISINE_TYPE_COUNT];
+
+        // Dietary properties per position in items_.
+        mutable DietaryIndex dietary_index_;
+
+        /**
+        * @struct CountedDish
+        * @brief What the totals hold for one dish, so it can be taken back out
+        even after the dish changed.
+        */
+        struct CountedDish {
+            uint64_t revision;
+            int prep_time;
+            Money price;
+            Dish::CuisineType cuisine_type;
+            bool elaborate;
+        };
+
+        // Per position in items_, as counted; and Dish::latestRevision() as of
+        // the last refresh().
+        mutable std::vector<CountedDish> counted_;
+        mutable uint64_t seen_revision_;
+
+        // Dishes to delete with the kitchen, see adoptDish(); they need not be held.
+        std::unordered_set<Dish*> owned_;
+
+        static const int EVENT_LOG_CAPACITY = 256;
+
+        // Change tracking: the current version, the ring buffer of recent
+        // events and the observers to notify.
+        mutable uint64_t version_;
+        mutable std::vector<KitchenEvent> event_log_; // grows to EVENT_LOG_CAPACITY, then wraps
+        mutable uint64_t event_count_;                // events ever logged
+        mutable uint64_t dropped_version_;            // version of the newest overwritten event, 0 if none
+        std::vector<KitchenObserver*> observers_;
+        mutable int change_depth_;                    // nesting of ChangeScope, e.g. serveDish() inside a release
+        mutable bool changed_;                        // whether the outermost ChangeScope logged an event
+
+        // The report lines as of report_version_, and the version at which each last changed.
+        mutable std::vector<std::string> report_lines_;
+        mutable std::vector<uint64_t> report_line_versions_;
+        mutable uint64_t report_version_;
+
+        /**
+        * @class ChangeScope
+        * @brief Groups the events of one operation under one version and
+        notifies the observers when the outermost scope ends.
+        */
+        class ChangeScope {
+            public:
+                explicit ChangeScope(const Kitchen& kitchen);
+                ~ChangeScope();
+            private:
+                const Kitchen& kitchen_;
+        };
+
+        /**
+        * Appends an event to the change log; the first event of an operation
+        advances the version. Must be called inside a ChangeScope.
+        * @param dish The dish added, removed or changed, or nullptr for DISHES_ADJUSTED.
+        */
+        void logEvent(const KitchenEvent::Kind& kind, const Dish* dish) const;
+
+        /**
+        * Deletes a dish that has just left the kitchen if the kitchen adopted it.
+        */
+        void releaseOwned(Dish* dish);
+
+        /**
+        * @return Whether the dish counts towards `elaborateDishCount()`.
+        */
+        static bool isElaborate(const Dish* dish);
+
+        /**
+        * Adds a dish to the running totals: prep time, elaborate count and revenue.
+        * @param counted Receives what was counted, for `uncountDish()`.
+        */
+        void countDish(const Dish* dish, CountedDish& counted) const;
+
+        /**
+        * Takes a dish out of the running totals as it was counted.
+        */
+        void uncountDish(const CountedDish& counted) const;
+
+        /**
+        * Recounts the held dishes whose revision changed since they were
+        counted: updates the totals, the dietary index and the top-k caches,
+        and logs a DISH_CHANGED event for each. Costs one comparison if no
+        dish anywhere changed since the last call.
+        */
+        void refresh() const;
+
+        /**
+        * Puts a dish in place of the one at a position, keeping every index current.
+        * @return The dish that was replaced.
+        */
+        Dish* replaceDish(const int& position, Dish* dish);
+
+        /**
+        * @return The value of the dish for the given ranking key.
+        */
+        static double rankValue(const Dish* dish, const RankKey& key);
+
+        /**
+        * Selects the k highest-ranked dishes in a single pass over the kitchen.
+        * @return Up to k dishes ordered from highest to lowest by key.
+        */
+        std::vector<Dish*> selectTopK(const RankKey& key, const int& k, const std::string& cuisine_type) const;
+
+        /**
+        * Updates the top-k caches after a dish has been added to the kitchen.
+        */
+        void rankDishAdded(Dish* dish) const;
+
+        /**
+        * Updates the top-k caches after a dish has been removed from the kitchen.
+        */
+        void rankDishRemoved(Dish* dish) const;
+
+        /**
+        * Drops all top-k caches, e.g. after dishes were modified in place.
+        */
+        void invalidateRankings();
+
+        /**
+        * Formats "MIN / P50 / P90 / P99 / MAX" of sorted values as one report line.
+        * @param as_price If true, values are cents and printed as dollars.
+        */
+        static std::string distributionLine(const std::string& label, const std::vector<long long>& sorted, const bool& as_price);
+
+        /**
+        * @param lines Receives the lines of `kitchenReport()`, without newlines.
+        */
+        void reportLines(std::vector<std::string>& lines) const;
+
+        /**
+        * Collects the prep times (minutes) and prices (cents) of the held
+        dishes in ascending order, so every reported percentile is a value a
+        dish actually has. The kitchen holds at most DEFAULT_CAPACITY dishes,
+        so this is cheaper than keeping them sorted on every change.
+        */
+        void sortedValues(std::vector<long long>& prep_times, std::vector<long long>& prices) const;
+
+        /**
+        * @param sorted Values in ascending order.
+        * @param values Receives MIN, P50, P90, P99 and MAX, by nearest rank; all 0 if there are no values.
+        */
+        static void distribution(const std::vector<long long>& sorted, long long (&values)[5]);
     
 };
 
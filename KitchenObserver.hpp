@@ -0,0 +1,50 @@
+#ifndef KITCHEN_OBSERVER_HPP
+#define KITCHEN_OBSERVER_HPP
+
+#include "Dish.hpp"
+#include <cstdint>
+#include <string>
+
+class Kitchen;
+
+/**
+ * @struct KitchenEvent
+ * @brief One change to a kitchen, as kept in its change log.
+ *
+ * All events of one kitchen operation, e.g. every dish a release removes,
+ * share the version that operation produced.
+ */
+struct KitchenEvent {
+    enum Kind { DISH_ADDED, DISH_REMOVED, DISHES_ADJUSTED, DISH_CHANGED };
+
+    Kind kind = DISH_ADDED;
+    uint64_t version = 0;
+    std::string dish_name;   ///< Empty for DISHES_ADJUSTED.
+    Dish::CuisineType cuisine_type = Dish::OTHER;
+    int prep_time = 0;
+    int dish_count = 0;      ///< DISHES_ADJUSTED only: the number of dishes adjusted.
+};
+
+/**
+ * @class KitchenObserver
+ * @brief Receives a notification after each kitchen operation that changed something.
+ *
+ * Notifications carry only the new version. Observers pull what they need
+ * with `Kitchen::eventsSince()` or `Kitchen::kitchenReportSince()`, so an
+ * operation costs the same however many events it produced.
+ */
+class KitchenObserver {
+public:
+    virtual ~KitchenObserver() = default;
+
+    /**
+     * Called after `newOrder()`, `newOrders()`, `serveDish()`, the releases,
+     `dietaryAdjustment()` or `applyMenuDiff()` changed the kitchen, or after
+     a call to the kitchen found a held dish changed in place. Must not modify the kitchen.
+     * @param kitchen The kitchen that changed.
+     * @param version Its new version, see `Kitchen::version()`.
+     */
+    virtual void kitchenChanged(const Kitchen& kitchen, const uint64_t& version) = 0;
+};
+
+#endif // KITCHEN_OBSERVER_HPP
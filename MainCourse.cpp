@@ -1,4 +1,8 @@
 #include "MainCourse.hpp"
+#include "DietaryMemo.hpp"
+
+const char* const MainCourse::COOKING_METHOD_NAMES[RAW + 1] = { "GRILLED", "BAKED", "BOILED", "FRIED", "STEAMED", "RAW" };
+const char* const MainCourse::CATEGORY_NAMES[VEGETABLE + 1] = { "GRAIN", "PASTA", "LEGUME", "BREAD", "SALAD", "SOUP", "STARCHES", "VEGETABLE" };
 
 /**
  * Default constructor.
@@ -19,8 +23,19 @@ MainCourse::MainCourse()
  * @param side_dishes The side dishes served with the main course.
  * @param gluten_free Flag indicating if the main course is gluten-free.
  */
-MainCourse::MainCourse(const std::string& name, const std::vector<std::string>& ingredients, const int &prep_time, const double &price, const CuisineType &cuisine_type, const CookingMethod &cooking_method, const std::string& protein_type, const std::vector<SideDish>& side_dishes, const bool &gluten_free)
-    : Dish(name, ingredients, prep_time, price, cuisine_type), cooking_method_(cooking_method), protein_type_(protein_type), side_dishes_(side_dishes), gluten_free_(gluten_free) {}
+MainCourse::MainCourse(const std::string& name, const std::vector<std::string>& ingredients, const int &prep_time, const Money &price, const CuisineType &cuisine_type, const CookingMethod &cooking_method, const std::string& protein_type, const std::vector<SideDish>& side_dishes, const bool &gluten_free)
+    : Dish(name, ingredients, prep_time, price, cuisine_type), cooking_method_(cooking_method), protein_type_(protein_type), side_dishes_(side_dishes), gluten_free_(gluten_free) {
+    refreshAllergens();
+}
+
+/**
+ * Parameterized constructor taking ownership of an already parsed name,
+ * ingredient list, protein type and side dishes, e.g. from a CSV loader.
+ */
+MainCourse::MainCourse(std::string&& name, std::vector<std::string>&& ingredients, const int &prep_time, const Money &price, const CuisineType &cuisine_type, const CookingMethod &cooking_method, std::string&& protein_type, std::vector<SideDish>&& side_dishes, const bool &gluten_free)
+    : Dish(std::move(name), std::move(ingredients), prep_time, price, cuisine_type), cooking_method_(cooking_method), protein_type_(std::move(protein_type)), side_dishes_(std::move(side_dishes)), gluten_free_(gluten_free) {
+    refreshAllergens();
+}
 
 /**
  * Sets the cooking method of the main course.
@@ -29,6 +44,7 @@ MainCourse::MainCourse(const std::string& name, const std::vector<std::string>&
  */
 void MainCourse::setCookingMethod(const CookingMethod &cooking_method) {
     cooking_method_ = cooking_method;
+    invalidateRender();
 }
 
 
@@ -48,6 +64,12 @@ MainCourse::CookingMethod MainCourse::getCookingMethod() const {
  */
 void MainCourse::setProteinType(const std::string& protein_type) {
     protein_type_ = protein_type;
+    invalidateRender();
+}
+
+void MainCourse::setProteinType(std::string&& protein_type) {
+    protein_type_ = std::move(protein_type);
+    invalidateRender();
 }
 
 /**
@@ -60,19 +82,34 @@ std::string MainCourse::getProteinType() const {
 /**
  * Adds a side dish to the main course.
  * @param side_dish A SideDish struct containing the name and category of the side dish.
- * @post Adds the side dish to the `side_dishes_` vector.
+ * @post Adds the side dish to the `side_dishes_` vector and updates the allergen mask.
  */
 void MainCourse::addSideDish(const SideDish& side_dish) {
     side_dishes_.push_back(side_dish);
+    refreshAllergens();
+    invalidateRender();
+}
+
+void MainCourse::addSideDish(SideDish&& side_dish) {
+    side_dishes_.push_back(std::move(side_dish));
+    refreshAllergens();
+    invalidateRender();
 }
 
 /**
  * @return A vector of SideDish structs representing the side dishes served with the main course.
  */
-std::vector<MainCourse::SideDish> MainCourse::getSideDishes() const {
+const std::vector<MainCourse::SideDish>& MainCourse::getSideDishes() const {
     return side_dishes_;
 }
 
+/**
+ * @return The number of side dishes served with the main course.
+ */
+int MainCourse::sideDishCount() const {
+    return side_dishes_.size();
+}
+
 /**
  * Sets the gluten-free flag of the main course.
  * @param gluten_free A boolean indicating if the main course is gluten-free.
@@ -80,6 +117,7 @@ std::vector<MainCourse::SideDish> MainCourse::getSideDishes() const {
  */
 void MainCourse::setGlutenFree(const bool &gluten_free) {
     gluten_free_ = gluten_free;
+    invalidateRender();
 }
 
 /**
@@ -114,14 +152,33 @@ Vegetables])
 */
 
 void MainCourse::display(){
+    std::cout << getRendered();
+}
+
+/**
+ * Formats the main course's details in the layout documented for display().
+ * @param ingredients The ingredients to show.
+ * @param request The dietary accommodations to show, or nullptr for none.
+ * @return The formatted details; Dish::getRendered() caches them for the dish itself.
+ */
+std::string MainCourse::renderWith(const IngredientList& ingredients, const DietaryRequest* request) const {
+
     std::string ingredList = "";
-    std::vector<std::string> g = getIngredients();
-    for (int i = 0; i < g.size(); i++) {
-        if (i != 0) {
+    bool first = true;
+    for (std::string_view name : ingredients.names()) {
+        if (!first) {
             ingredList += ", "; 
         }
-        ingredList += g[i];
+        ingredList += name;
+        first = false;
+    }
+
+    std::string protein_type = getProteinType();
+    bool gluten_free = declaredAllergens(request) == 0;
+    if (request != nullptr && (request->vegetarian || request->vegan)) {
+        protein_type = "Tofu";
     }
+    bool skip_gluten_sides = request != nullptr && request->gluten_free;
 
     CookingMethod m = getCookingMethod();
     std::string x;
@@ -147,9 +204,12 @@ void MainCourse::display(){
       }
 
 
-    std::vector<MainCourse::SideDish> mai =  side_dishes_;
+    const std::vector<MainCourse::SideDish>& mai =  side_dishes_;
     std::string sidestring = "";
     for (int i = 0; i < mai.size();i++) {
+        if (skip_gluten_sides && isGlutenCategory(mai[i].category)) {
+            continue;
+        }
         std::string me;
             if (mai[i].category ==  MainCourse::Category::GRAIN ) {
                 me = "Grain";
@@ -179,24 +239,26 @@ void MainCourse::display(){
                 me = "UNKNOWN";
             }
 
-            sidestring += mai[i].name + " (Category: " + me + ")";
-            if (i < mai.size() - 1) {
+            if (!sidestring.empty()) {
                 sidestring += ", "; 
             }
+            sidestring += mai[i].name + " (Category: " + me + ")";
     }
 
 
 
 
-    std::cout << "Dish Name: " << getName() << std::endl <<
+    std::ostringstream out;
+    out << "Dish Name: " << getName() << std::endl <<
     "Ingredients: " << ingredList << std::endl <<
     "Preparation Time: " << getPrepTime() << " minutes" << std::endl <<
-    "Price: $" << std::fixed << std::setprecision(2) << getPrice() << std::endl << 
+    "Price: $" << getPrice() << std::endl <<
     "Cuisine Type: " << getCuisineType() << std::endl <<
     "Cooking Method: " << x << std::endl <<
-    "Protein Type: " << getProteinType() << std::endl <<
+    "Protein Type: " << protein_type << std::endl <<
     "Side Dishes: " << sidestring << std::endl <<
-    "Gluten-Free: " << (isGlutenFree() ? "Yes" : "No") << std::endl;
+    "Gluten-Free: " << (gluten_free ? "Yes" : "No") << std::endl;
+    return out.str();
     
 }
 
@@ -217,6 +279,8 @@ replaced with "Mushrooms". If there are more, they will be removed
 without substitution.
 * Non-vegetarian ingredients are: "Meat", "Chicken",
 "Fish", "Beef", "Pork", "Lamb", "Shrimp", "Bacon".
+* Ingredient classes and substitutes are those of the dietary rules,
+see `IngredientTable::loadRules()`; the lists here are the defaults.
 * - If `request.vegan` is true:
 * - Changes `protein_type_` to "Tofu".
 * - Removes dairy and egg ingredients from `ingredients_`.
@@ -228,66 +292,159 @@ without substitution.
 involves gluten.
 * Gluten-containing side dish categories are: `GRAIN`,
 `PASTA`, `BREAD`, `STARCHES`.
+* - Removes ingredients in the allergen classes of `request.avoid`.
 */
 void MainCourse::dietaryAccommodations(const DietaryRequest& request)  {
-    std::vector<std::string> ingredList = getIngredients();
-    int count = 0;
-    if (request.vegetarian) {
-        protein_type_ = "Tofu";
-        for (int i = 0; i < ingredList.size();i++) {
-            if (ingredList[i] == "Meat" || ingredList[i] == "Chicken" || ingredList[i] == "Fish"
-            || ingredList[i] == "Beef" || ingredList[i] == "Pork" || ingredList[i] == "Lamb"
-            || ingredList[i] == "Shrimp" || ingredList[i] == "Bacon") {
-                if (count == 0) {
-                    ingredList[i] = "Beans";
-                }
-                else if (count == 1 ) {
-                    ingredList[i] = "Mushrooms";
-                }
-                else if (count > 1 ) {
-                    ingredList.erase(ingredList.begin() + i); 
-                    i--;
-                }
-                count++;
-            }
-        }
-                setIngredients(ingredList);
+    IngredientList ingredients = getIngredientIds();
+    DietaryMemo::instance().apply(dietaryPlan(request), ingredients);
+    applyDietaryResult(request, std::move(ingredients));
+}
 
+/**
+ * @param request The dietary accommodations.
+ * @return What `dietaryAccommodations()` does to the ingredients.
+ */
+DietaryPlan MainCourse::dietaryPlan(const DietaryRequest& request) const {
+    DietaryPlan plan;
+    if (request.vegetarian) {
+        plan.substitute = IngredientTable::MEAT;
     }
     if (request.vegan) {
-        protein_type_ = "Tofu";
-        for (int i = 0; i < ingredList.size();i++) {
-             if (ingredList[i] == "Milk" || ingredList[i] == "Eggs" || ingredList[i] == "Cheese"
-            || ingredList[i] == "Butter" || ingredList[i] == "Cream" || ingredList[i] == "Yogurt") {
-                ingredList.erase(ingredList.begin()+i);
-                i--;
-            }
-
-        }
-        setIngredients(ingredList);
-
+        plan.remove |= IngredientTable::DAIRY_EGG;
+    }
+    plan.remove |= request.avoid;
+    return plan;
+}
 
+/**
+ * Adjusts the remaining attributes as documented for `dietaryAccommodations()`.
+ * @param request The dietary accommodations.
+ * @param ingredients The ingredients with `dietaryPlan(request)` applied.
+ */
+void MainCourse::applyDietaryResult(const DietaryRequest& request, IngredientList&& ingredients) {
+    invalidateRender();
+    if (request.vegetarian || request.vegan) {
+        protein_type_ = "Tofu";
     }
     if (request.gluten_free) {
         gluten_free_ = true;
         for (int i = 0; i < side_dishes_.size();i++) {
-             if (side_dishes_[i].category == Category::GRAIN || side_dishes_[i].category == Category::PASTA ||
-             side_dishes_[i].category == Category::BREAD || side_dishes_[i].category == Category::STARCHES) {
-                    side_dishes_.erase(side_dishes_.begin()+i);
-                    i--;
-                }
+            if (isGlutenCategory(side_dishes_[i].category)) {
+                side_dishes_.erase(side_dishes_.begin()+i);
+                i--;
             }
-
-
         }
-
-
-
-    
+        refreshAllergens();
+    }
+    Dish::applyDietaryResult(request, std::move(ingredients));
 }
 
+/**
+ * Adds the dish's heap blocks, including the protein type and side dishes, to `usage`.
+ * @param usage The totals to add to.
+ */
+void MainCourse::addMemoryUsage(MemoryUsage& usage) const {
+    Dish::addMemoryUsage(usage);
+    usage.names += MemoryUsage::allocatedSize(protein_type_);
+    usage.side_dishes += MemoryUsage::allocatedSize(side_dishes_);
+    for (const SideDish& side_dish : side_dishes_) {
+        usage.side_dishes += MemoryUsage::allocatedSize(side_dish.name);
+    }
+}
 
+/**
+ * @param request Dietary accommodations to take into account, or nullptr for none.
+ * @return GLUTEN if any side dish belongs to a gluten-containing category
+ (`GRAIN`, `PASTA`, `BREAD`, `STARCHES`), otherwise no allergen classes.
+ A gluten-free request removes those side dishes.
+ */
+AllergenMask MainCourse::componentAllergens(const DietaryRequest* request) const {
+    if (request != nullptr && request->gluten_free) {
+        return 0;
+    }
+    for (const SideDish& side_dish : side_dishes_) {
+        if (isGlutenCategory(side_dish.category)) {
+            return IngredientTable::GLUTEN;
+        }
+    }
+    return 0;
+}
 
+/**
+ * @param request Dietary accommodations to take into account, or nullptr for none.
+ * @return GLUTEN unless the main course is flagged gluten-free.
+ */
+AllergenMask MainCourse::declaredAllergens(const DietaryRequest* request) const {
+    if (gluten_free_ || (request != nullptr && request->gluten_free)) {
+        return 0;
+    }
+    return IngredientTable::GLUTEN;
+}
 
+bool MainCourse::isGlutenCategory(const Category& category) {
+    return category == Category::GRAIN || category == Category::PASTA ||
+        category == Category::BREAD || category == Category::STARCHES;
+}
 
-
+/**
+ * Appends the main course as a JSON object, a Dishes.csv row (with newline) or a
+ binary record tagged 2.
+ * @param format The encoding to use.
+ * @param buffer The buffer to append to.
+ */
+void MainCourse::serialize(const Format& format, std::string& buffer) const {
+    SerialWriter writer(buffer);
+    serializeCommon(format, writer, "MAINCOURSE", 2);
+    bool first = true;
+    switch (format) {
+        case JSON:
+            writer.text(",\"cooking_method\":");
+            writer.jsonString(COOKING_METHOD_NAMES[cooking_method_]);
+            writer.text(",\"protein_type\":");
+            writer.jsonString(protein_type_);
+            writer.text(",\"side_dishes\":[");
+            for (const SideDish& side : side_dishes_) {
+                if (!first) {
+                    writer.character(',');
+                }
+                writer.text("{\"name\":");
+                writer.jsonString(side.name);
+                writer.text(",\"category\":");
+                writer.jsonString(CATEGORY_NAMES[side.category]);
+                writer.character('}');
+                first = false;
+            }
+            writer.text("],\"gluten_free\":");
+            writer.boolean(gluten_free_);
+            writer.character('}');
+            break;
+        case CSV:
+            writer.text(COOKING_METHOD_NAMES[cooking_method_]);
+            writer.character(';');
+            writer.text(protein_type_);
+            writer.character(';');
+            for (const SideDish& side : side_dishes_) {
+                if (!first) {
+                    writer.character('|');
+                }
+                writer.text(side.name);
+                writer.character(':');
+                writer.text(CATEGORY_NAMES[side.category]);
+                first = false;
+            }
+            writer.character(';');
+            writer.boolean(gluten_free_);
+            writer.character('\n');
+            break;
+        case BINARY:
+            writer.byte(uint8_t(cooking_method_));
+            writer.bytes(protein_type_);
+            writer.varint(side_dishes_.size());
+            for (const SideDish& side_dish : side_dishes_) {
+                writer.bytes(side_dish.name);
+                writer.byte(uint8_t(side_dish.category));
+            }
+            writer.byte(gluten_free_);
+            break;
+    }
+}
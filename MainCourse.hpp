@@ -20,12 +20,22 @@ public:
      */
     enum CookingMethod { GRILLED, BAKED, BOILED, FRIED, STEAMED, RAW };
 
+    /**
+     * Names of the CookingMethod enumerators, indexed by value.
+     */
+    static const char* const COOKING_METHOD_NAMES[RAW + 1];
+
     /**
      * @enum Category
      * @brief Describes the category of the side dish.
      */
     enum Category { GRAIN, PASTA, LEGUME, BREAD, SALAD, SOUP, STARCHES, VEGETABLE };
 
+    /**
+     * Names of the Category enumerators, indexed by value.
+     */
+    static const char* const CATEGORY_NAMES[VEGETABLE + 1];
+
     /**
      * @struct SideDish
      * @brief Represents a side dish associated with the main course.
@@ -53,10 +63,21 @@ public:
      * @param side_dishes The side dishes served with the main course.
      * @param gluten_free Flag indicating if the main course is gluten-free.
      */
-    MainCourse(const std::string& name, const std::vector<std::string>& ingredients, const int &prep_time, const double &price, const CuisineType &cuisine_type, const CookingMethod &cooking_method, const std::string& protein_type, const std::vector<SideDish>& side_dishes, const bool &gluten_free);
+    MainCourse(const std::string& name, const std::vector<std::string>& ingredients, const int &prep_time, const Money &price, const CuisineType &cuisine_type, const CookingMethod &cooking_method, const std::string& protein_type, const std::vector<SideDish>& side_dishes, const bool &gluten_free);
+
+    /**
+     * Parameterized constructor taking ownership of an already parsed name,
+     * ingredient list, protein type and side dishes, e.g. from a CSV loader.
+     */
+    MainCourse(std::string&& name, std::vector<std::string>&& ingredients, const int &prep_time, const Money &price, const CuisineType &cuisine_type, const CookingMethod &cooking_method, std::string&& protein_type, std::vector<SideDish>&& side_dishes, const bool &gluten_free);
 
 
-        ~MainCourse() override; 
+    MainCourse(const MainCourse&) = default;
+    MainCourse(MainCourse&&) = default;
+    MainCourse& operator=(const MainCourse&) = default;
+    MainCourse& operator=(MainCourse&&) = default;
+
+    ~MainCourse() override;
 
     /**
      * Sets the cooking method of the main course.
@@ -76,6 +97,7 @@ public:
      * @post Sets the private member `protein_type_` to the value of the parameter.
      */
     void setProteinType(const std::string& protein_type);
+    void setProteinType(std::string&& protein_type);
 
     /**
      * @return The type of protein in the main course.
@@ -85,14 +107,20 @@ public:
     /**
      * Adds a side dish to the main course.
      * @param side_dish A SideDish struct containing the name and category of the side dish.
-     * @post Adds the side dish to the `side_dishes_` vector.
+     * @post Adds the side dish to the `side_dishes_` vector and updates the allergen mask.
      */
     void addSideDish(const SideDish& side_dish);
+    void addSideDish(SideDish&& side_dish);
 
     /**
      * @return A vector of SideDish structs representing the side dishes served with the main course.
      */
-    std::vector<SideDish> getSideDishes() const;
+    const std::vector<SideDish>& getSideDishes() const;
+
+    /**
+     * @return The number of side dishes served with the main course.
+     */
+    int sideDishCount() const;
 
     /**
      * Sets the gluten-free flag of the main course.
@@ -142,6 +170,8 @@ replaced with "Mushrooms". If there are more, they will be removed
 without substitution.
 * Non-vegetarian ingredients are: "Meat", "Chicken",
 "Fish", "Beef", "Pork", "Lamb", "Shrimp", "Bacon".
+* Ingredient classes and substitutes are those of the dietary rules,
+see `IngredientTable::loadRules()`; the lists here are the defaults.
 * - If `request.vegan` is true:
 * - Changes `protein_type_` to "Tofu".
 * - Removes dairy and egg ingredients from `ingredients_`.
@@ -153,16 +183,71 @@ without substitution.
 involves gluten.
 * Gluten-containing side dish categories are: `GRAIN`,
 `PASTA`, `BREAD`, `STARCHES`.
+* - Removes ingredients in the allergen classes of `request.avoid`.
 */
 
 void dietaryAccommodations(const DietaryRequest& request) override;
 
+/**
+ * @param request The dietary accommodations.
+ * @return What `dietaryAccommodations()` does to the ingredients.
+ */
+DietaryPlan dietaryPlan(const DietaryRequest& request) const override;
+
+/**
+ * Adjusts the remaining attributes as documented for `dietaryAccommodations()`.
+ * @param request The dietary accommodations.
+ * @param ingredients The ingredients with `dietaryPlan(request)` applied.
+ */
+void applyDietaryResult(const DietaryRequest& request, IngredientList&& ingredients) override;
+
+/**
+ * Formats the main course's details in the layout documented for display().
+ * @param ingredients The ingredients to show.
+ * @param request The dietary accommodations to show, or nullptr for none.
+ * @return The formatted details; Dish::getRendered() caches them for the dish itself.
+ */
+std::string renderWith(const IngredientList& ingredients, const DietaryRequest* request) const override;
+
+/**
+ * Appends the main course as a JSON object, a Dishes.csv row (with newline) or a
+ binary record tagged 2.
+ * @param format The encoding to use.
+ * @param buffer The buffer to append to.
+ */
+void serialize(const Format& format, std::string& buffer) const override;
+
+/**
+ * Adds the dish's heap blocks, including the protein type and side dishes, to `usage`.
+ * @param usage The totals to add to.
+ */
+void addMemoryUsage(MemoryUsage& usage) const override;
+
+protected:
+    /**
+     * @param request Dietary accommodations to take into account, or nullptr for none.
+     * @return GLUTEN if any side dish belongs to a gluten-containing category
+     (`GRAIN`, `PASTA`, `BREAD`, `STARCHES`), otherwise no allergen classes.
+     A gluten-free request removes those side dishes.
+     */
+    AllergenMask componentAllergens(const DietaryRequest* request) const override;
+
+    /**
+     * @param request Dietary accommodations to take into account, or nullptr for none.
+     * @return GLUTEN unless the main course is flagged gluten-free.
+     */
+    AllergenMask declaredAllergens(const DietaryRequest* request) const override;
 
 private:
     CookingMethod cooking_method_; ///< The cooking method used for the main course.
     std::string protein_type_; ///< The type of protein used in the main course.
     std::vector<SideDish> side_dishes_; ///< The side dishes served with the main course.
     bool gluten_free_; ///< Flag indicating if the main course is gluten-free.
+
+    /**
+     * @return True if side dishes of this category contain gluten.
+     */
+    static bool isGlutenCategory(const Category& category);
 };
 
 #endif // MAINCOURSE_HPP
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "MemoryUsage.hpp"
+
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(__GLIBC__) || defined(__linux__)
+#include <malloc.h>
+#endif
+
+/**
+ * @return The sum of all categories.
+ */
+size_t MemoryUsage::total() const {
+    return kitchen + indexes + dishBytes();
+}
+
+/**
+ * @return The bytes attributable to individual dishes: everything but the kitchen and its indexes.
+ */
+size_t MemoryUsage::dishBytes() const {
+    return dish_objects + names + ingredients + side_dishes + caches;
+}
+
+/**
+ * @param block A pointer returned by malloc or operator new, or nullptr.
+ * @return The usable size of the block, 0 for nullptr or where the platform cannot tell.
+ */
+size_t MemoryUsage::allocatedSize(const void* block) {
+    if (block == nullptr) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return malloc_size(block);
+#elif defined(__GLIBC__) || defined(__linux__)
+    return malloc_usable_size(const_cast<void*>(block));
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @return The size of the string's heap buffer, 0 if it is stored inline.
+ */
+size_t MemoryUsage::allocatedSize(const std::string& text) {
+    const char* data = text.data();
+    const char* object = reinterpret_cast<const char*>(&text);
+    if (data >= object && data < object + sizeof(text)) {
+        return 0;
+    }
+    return allocatedSize(data);
+}
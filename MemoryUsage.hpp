@@ -0,0 +1,58 @@
+#ifndef MEMORY_USAGE_HPP
+#define MEMORY_USAGE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @struct MemoryUsage
+ * @brief Heap bytes held by a kitchen, by category.
+ *
+ * Every figure is the size the allocator actually reserved for each block
+ * (`malloc_usable_size()`, or `malloc_size()` on Apple platforms), so it
+ * includes rounding to the allocator's size classes but not its per-block
+ * headers. Strings stored inline (short string optimization) cost nothing
+ * beyond the object holding them. Ingredient names are interned once per
+ * process in IngredientTable and are not counted.
+ */
+struct MemoryUsage {
+    size_t kitchen = 0;         ///< The Kitchen object itself, including its ArrayBag slots.
+    size_t dish_objects = 0;    ///< The dish objects.
+    size_t names = 0;           ///< Dish names and other text fields, such as protein types.
+    size_t ingredients = 0;     ///< Ingredient lists that outgrew their inline storage.
+    size_t side_dishes = 0;     ///< Side dish vectors and their names.
+    size_t caches = 0;          ///< Cached display text and top-k rankings.
+    size_t indexes = 0;         ///< The dietary index, the change log and report lines.
+
+    /**
+     * @return The sum of all categories.
+     */
+    size_t total() const;
+
+    /**
+     * @return The bytes attributable to individual dishes: everything but the kitchen and its indexes.
+     */
+    size_t dishBytes() const;
+
+    /**
+     * @param block A pointer returned by malloc or operator new, or nullptr.
+     * @return The usable size of the block, 0 for nullptr or where the platform cannot tell.
+     */
+    static size_t allocatedSize(const void* block);
+
+    /**
+     * @return The size of the string's heap buffer, 0 if it is stored inline.
+     */
+    static size_t allocatedSize(const std::string& text);
+
+    /**
+     * @return The size of the vector's heap buffer, 0 if it has none.
+     */
+    template <typename T>
+    static size_t allocatedSize(const std::vector<T>& items) {
+        return items.capacity() == 0 ? 0 : allocatedSize(items.data());
+    }
+};
+
+#endif // MEMORY_USAGE_HPP
@@ -0,0 +1,544 @@
+#include "MenuArchive.hpp"
+#include "Appetizer.hpp"
+#include "Dessert.hpp"
+#include "DishCsv.hpp"
+#include "Kitchen.hpp"
+#include "MainCourse.hpp"
+#include "Serializable.hpp"
+#include <algorithm>
+#include <zlib.h>
+
+namespace {
+
+// version 2 stores cuisines as dictionary strings instead of CuisineType bytes
+const char MAGIC[8] = { 'M', 'E', 'N', 'U', 'A', 'R', 'C', '2' };
+const size_t FOOTER_SIZE = 16; // index offset as 8 bytes little-endian, then MAGIC
+
+// Blocks and the dictionary larger than this are treated as corrupt.
+const uint64_t MAX_SECTION_SIZE = uint64_t(1) << 30;
+
+enum Column { KIND, NAME, CUISINE, PREP_TIME, PRICE, INGREDIENTS, ATTRIBUTES };
+enum DishKind { APPETIZER, MAINCOURSE, DESSERT };
+
+/**
+ * Reads the varints and bytes written by SerialWriter from a buffer,
+ * failing instead of reading past its end.
+ */
+class ByteReader {
+public:
+    ByteReader(const char* data, const size_t& size) : data_(data), end_(data + size) {}
+
+    bool byte(uint8_t& value) {
+        if (data_ == end_) {
+            return false;
+        }
+        value = uint8_t(*data_++);
+        return true;
+    }
+
+    bool varint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && data_ != end_; shift += 7) {
+            uint8_t next = uint8_t(*data_++);
+            value |= uint64_t(next & 0x7f) << shift;
+            if ((next & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool signedVarint(int64_t& value) {
+        uint64_t encoded;
+        if (!varint(encoded)) {
+            return false;
+        }
+        value = int64_t(encoded >> 1) ^ -int64_t(encoded & 1);
+        return true;
+    }
+
+    /**
+     * Reads a varint length and that many bytes.
+     */
+    bool bytes(std::string_view& text) {
+        uint64_t size;
+        if (!varint(size) || size > uint64_t(end_ - data_)) {
+            return false;
+        }
+        text = std::string_view(data_, size);
+        data_ += size;
+        return true;
+    }
+
+private:
+    const char* data_;
+    const char* end_;
+};
+
+/**
+ * Reads a dictionary ID and looks it up.
+ */
+bool readString(ByteReader& reader, const std::vector<std::string>& dictionary, std::string& text) {
+    uint64_t id;
+    if (!reader.varint(id) || id >= dictionary.size()) {
+        return false;
+    }
+    text = dictionary[id];
+    return true;
+}
+
+/**
+ * Reads an enum byte and checks it against the number of enumerators.
+ */
+bool readEnum(ByteReader& reader, const int& count, int& value) {
+    uint8_t byte;
+    if (!reader.byte(byte) || byte >= count) {
+        return false;
+    }
+    value = byte;
+    return true;
+}
+
+} // namespace
+
+MenuArchiveWriter::MenuArchiveWriter(const std::string& filename, const size_t& block_rows)
+    : file_(filename, std::ios::binary | std::ios::trunc), ok_(false), block_rows_(block_rows == 0 ? 1 : block_rows),
+      offset_(0), row_count_(0), block_size_(0), previous_prep_time_(0), previous_cents_(0) {
+    ok_ = bool(file_.write(MAGIC, sizeof(MAGIC)));
+    offset_ = sizeof(MAGIC);
+}
+
+bool MenuArchiveWriter::isOpen() const {
+    return ok_;
+}
+
+uint64_t MenuArchiveWriter::rowCount() const {
+    return row_count_;
+}
+
+uint64_t MenuArchiveWriter::fileSize() const {
+    return offset_;
+}
+
+uint64_t MenuArchiveWriter::stringId(const std::string_view& text) {
+    auto inserted = dictionary_ids_.emplace(std::string(text), dictionary_.size());
+    if (inserted.second) {
+        dictionary_.push_back(inserted.first->first);
+    }
+    return inserted.first->second;
+}
+
+/**
+ * Appends a dish to the current block, writing the block once it is full.
+ * @param cuisine_name The cuisine as the menu wrote it; if empty, the dish's own cuisine type.
+ * @return False if the archive is not open or a block could not be written.
+ */
+bool MenuArchiveWriter::add(const Dish* dish, const std::string& cuisine_name) {
+    if (!ok_ || dish == nullptr) {
+        return false;
+    }
+    const Appetizer* appetizer = dynamic_cast<const Appetizer*>(dish);
+    const MainCourse* main_course = dynamic_cast<const MainCourse*>(dish);
+    const Dessert* dessert = dynamic_cast<const Dessert*>(dish);
+    if (appetizer == nullptr && main_course == nullptr && dessert == nullptr) {
+        return false;
+    }
+
+    SerialWriter kinds(columns_[KIND]);
+    SerialWriter attributes(columns_[ATTRIBUTES]);
+    if (appetizer != nullptr) {
+        kinds.byte(APPETIZER);
+        attributes.byte(uint8_t(appetizer->getServingStyle()));
+        attributes.signedVarint(appetizer->getSpicinessLevel());
+        attributes.byte(appetizer->isVegetarian());
+    } else if (main_course != nullptr) {
+        kinds.byte(MAINCOURSE);
+        attributes.byte(uint8_t(main_course->getCookingMethod()));
+        attributes.varint(stringId(main_course->getProteinType()));
+        attributes.varint(main_course->getSideDishes().size());
+        for (const MainCourse::SideDish& side : main_course->getSideDishes()) {
+            attributes.varint(stringId(side.name));
+            attributes.byte(uint8_t(side.category));
+        }
+        attributes.byte(main_course->isGlutenFree());
+    } else {
+        kinds.byte(DESSERT);
+        attributes.byte(uint8_t(dessert->getFlavorProfile()));
+        attributes.signedVarint(dessert->getSweetnessLevel());
+        attributes.byte(dessert->containsNuts());
+    }
+
+    SerialWriter(columns_[NAME]).varint(stringId(dish->getName()));
+    SerialWriter(columns_[CUISINE]).varint(stringId(cuisine_name.empty() ? dish->getCuisineType() : cuisine_name));
+    int64_t cents = dish->getPrice().getCents();
+    SerialWriter(columns_[PREP_TIME]).signedVarint(int64_t(dish->getPrepTime()) - previous_prep_time_);
+    SerialWriter(columns_[PRICE]).signedVarint(cents - previous_cents_);
+    previous_prep_time_ = dish->getPrepTime();
+    previous_cents_ = cents;
+    SerialWriter ingredients(columns_[INGREDIENTS]);
+    ingredients.varint(dish->ingredientCount());
+    for (std::string_view name : dish->getIngredientIds().names()) {
+        ingredients.varint(stringId(name));
+    }
+
+    row_count_++;
+    if (++block_size_ == block_rows_) {
+        return flushBlock();
+    }
+    return true;
+}
+
+bool MenuArchiveWriter::writeCompressed(const std::string& raw, uint64_t& compressed_size) {
+    uLongf size = compressBound(uLong(raw.size()));
+    std::string compressed(size, '\0');
+    if (compress2(reinterpret_cast<Bytef*>(&compressed[0]), &size, reinterpret_cast<const Bytef*>(raw.data()),
+            uLong(raw.size()), Z_DEFAULT_COMPRESSION) != Z_OK) {
+        return false;
+    }
+    compressed_size = size;
+    offset_ += size;
+    return bool(file_.write(compressed.data(), std::streamsize(size)));
+}
+
+/**
+ * Writes the current block: the row count, then each column as a varint
+ * length and its bytes, compressed as a whole.
+ */
+bool MenuArchiveWriter::flushBlock() {
+    if (block_size_ == 0) {
+        return ok_;
+    }
+    std::string raw;
+    SerialWriter writer(raw);
+    writer.varint(block_size_);
+    for (std::string& column : columns_) {
+        writer.bytes(column);
+        column.clear();
+    }
+    BlockInfo info = { 0, raw.size(), block_size_ };
+    ok_ = ok_ && writeCompressed(raw, info.compressed_size);
+    blocks_.push_back(info);
+    block_size_ = 0;
+    previous_prep_time_ = 0;
+    previous_cents_ = 0;
+    return ok_;
+}
+
+/**
+ * Writes the last block, the dictionary, the index and the footer.
+ * @return True if the whole archive was written.
+ */
+bool MenuArchiveWriter::close() {
+    if (!ok_ || !flushBlock()) {
+        ok_ = false;
+        return false;
+    }
+    std::string raw;
+    SerialWriter writer(raw);
+    writer.varint(dictionary_.size());
+    for (const std::string& text : dictionary_) {
+        writer.bytes(text);
+    }
+    uint64_t dictionary_offset = offset_;
+    uint64_t dictionary_size = 0;
+    if (!writeCompressed(raw, dictionary_size)) {
+        ok_ = false;
+        return false;
+    }
+
+    std::string index;
+    SerialWriter index_writer(index);
+    index_writer.varint(dictionary_offset);
+    index_writer.varint(dictionary_size);
+    index_writer.varint(raw.size());
+    index_writer.varint(blocks_.size());
+    for (const BlockInfo& block : blocks_) {
+        index_writer.varint(block.compressed_size);
+        index_writer.varint(block.raw_size);
+        index_writer.varint(block.rows);
+    }
+    uint64_t index_offset = offset_;
+    for (int i = 0; i < 8; i++) {
+        index_writer.byte(uint8_t(index_offset >> (8 * i)));
+    }
+    index.append(MAGIC, sizeof(MAGIC));
+    offset_ += index.size();
+    ok_ = bool(file_.write(index.data(), std::streamsize(index.size())) && file_.flush());
+    file_.close();
+    bool written = ok_;
+    ok_ = false; // nothing more can be added
+    return written;
+}
+
+MenuArchiveReader::MenuArchiveReader() : row_count_(0) {}
+
+uint64_t MenuArchiveReader::rowCount() const {
+    return row_count_;
+}
+
+size_t MenuArchiveReader::blockCount() const {
+    return blocks_.size();
+}
+
+/**
+ * Reads the footer, the index and the dictionary.
+ * @return False if the file could not be read or is not a complete archive.
+ */
+bool MenuArchiveReader::open(const std::string& filename) {
+    dictionary_.clear();
+    blocks_.clear();
+    row_count_ = 0;
+    file_.close();
+    file_.open(filename, std::ios::binary);
+    char header[sizeof(MAGIC)];
+    if (!file_.read(header, sizeof(header)) || !std::equal(header, header + sizeof(MAGIC), MAGIC)) {
+        return false;
+    }
+    file_.seekg(0, std::ios::end);
+    uint64_t file_size = uint64_t(file_.tellg());
+    char footer[FOOTER_SIZE];
+    if (file_size < sizeof(MAGIC) + FOOTER_SIZE || !file_.seekg(file_size - FOOTER_SIZE)
+        || !file_.read(footer, sizeof(footer)) || !std::equal(footer + 8, footer + FOOTER_SIZE, MAGIC)) {
+        return false;
+    }
+    uint64_t index_offset = 0;
+    for (int i = 0; i < 8; i++) {
+        index_offset |= uint64_t(uint8_t(footer[i])) << (8 * i);
+    }
+    if (index_offset < sizeof(MAGIC) || index_offset > file_size - FOOTER_SIZE) {
+        return false;
+    }
+    std::string index(file_size - FOOTER_SIZE - index_offset, '\0');
+    if (!file_.seekg(index_offset) || !file_.read(&index[0], std::streamsize(index.size()))) {
+        return false;
+    }
+
+    ByteReader reader(index.data(), index.size());
+    uint64_t dictionary_offset, dictionary_size, dictionary_raw_size, block_count;
+    if (!reader.varint(dictionary_offset) || !reader.varint(dictionary_size) || !reader.varint(dictionary_raw_size)
+        || !reader.varint(block_count) || block_count > index.size()) {
+        return false;
+    }
+    uint64_t offset = sizeof(MAGIC);
+    for (uint64_t i = 0; i < block_count; i++) {
+        BlockInfo block = { offset, 0, 0, row_count_, 0 };
+        if (!reader.varint(block.compressed_size) || !reader.varint(block.raw_size) || !reader.varint(block.rows)
+            || block.compressed_size > dictionary_offset - offset) {
+            return false;
+        }
+        offset += block.compressed_size;
+        row_count_ += block.rows;
+        blocks_.push_back(block);
+    }
+
+    std::string raw;
+    if (offset != dictionary_offset
+        || !readCompressed(dictionary_offset, dictionary_size, dictionary_raw_size, raw)) {
+        return false;
+    }
+    ByteReader dictionary(raw.data(), raw.size());
+    uint64_t count;
+    if (!dictionary.varint(count) || count > raw.size()) {
+        return false;
+    }
+    dictionary_.reserve(count);
+    std::string_view text;
+    for (uint64_t i = 0; i < count; i++) {
+        if (!dictionary.bytes(text)) {
+            return false;
+        }
+        dictionary_.emplace_back(text);
+    }
+    return true;
+}
+
+bool MenuArchiveReader::readCompressed(const uint64_t& offset, const uint64_t& size, const uint64_t& raw_size,
+    std::string& raw) {
+    if (size > MAX_SECTION_SIZE || raw_size > MAX_SECTION_SIZE) {
+        return false;
+    }
+    std::string compressed(size, '\0');
+    file_.clear();
+    if (!file_.seekg(offset) || !file_.read(&compressed[0], std::streamsize(size))) {
+        return false;
+    }
+    raw.assign(raw_size, '\0');
+    uLongf inflated = uLongf(raw_size);
+    return uncompress(reinterpret_cast<Bytef*>(&raw[0]), &inflated, reinterpret_cast<const Bytef*>(compressed.data()),
+        uLong(size)) == Z_OK && inflated == raw_size;
+}
+
+/**
+ * Decodes rows [skip, skip + limit) of a block. Earlier rows are still
+ * walked, since the columns are varint-encoded, but no dishes are built for them.
+ */
+bool MenuArchiveReader::readBlock(const size_t& block, const uint64_t& skip, const uint64_t& limit,
+    std::vector<Dish*>& dishes, std::vector<std::string>* cuisine_names) {
+    const BlockInfo& info = blocks_[block];
+    std::string raw;
+    if (!readCompressed(info.offset, info.compressed_size, info.raw_size, raw)) {
+        return false;
+    }
+    ByteReader reader(raw.data(), raw.size());
+    uint64_t rows;
+    std::string_view spans[7];
+    if (!reader.varint(rows) || rows != info.rows) {
+        return false;
+    }
+    for (std::string_view& span : spans) {
+        if (!reader.bytes(span)) {
+            return false;
+        }
+    }
+    ByteReader kinds(spans[KIND].data(), spans[KIND].size());
+    ByteReader names(spans[NAME].data(), spans[NAME].size());
+    ByteReader cuisines(spans[CUISINE].data(), spans[CUISINE].size());
+    ByteReader prep_times(spans[PREP_TIME].data(), spans[PREP_TIME].size());
+    ByteReader prices(spans[PRICE].data(), spans[PRICE].size());
+    ByteReader ingredient_ids(spans[INGREDIENTS].data(), spans[INGREDIENTS].size());
+    ByteReader attributes(spans[ATTRIBUTES].data(), spans[ATTRIBUTES].size());
+
+    int64_t prep_time = 0;
+    int64_t cents = 0;
+    std::string name;
+    std::string cuisine_name;
+    std::string text;
+    for (uint64_t row = 0; row < rows && row < skip + limit; row++) {
+        int kind;
+        int64_t prep_delta, price_delta;
+        uint64_t ingredient_count;
+        if (!readEnum(kinds, DESSERT + 1, kind) || !readString(names, dictionary_, name)
+            || !readString(cuisines, dictionary_, cuisine_name) || !prep_times.signedVarint(prep_delta)
+            || !prices.signedVarint(price_delta) || !ingredient_ids.varint(ingredient_count)
+            || ingredient_count > spans[INGREDIENTS].size()) {
+            return false;
+        }
+        prep_time += prep_delta;
+        cents += price_delta;
+        Dish::CuisineType cuisine = DishCsv::parseCuisineType(cuisine_name);
+        std::vector<std::string> ingredients(ingredient_count);
+        for (std::string& ingredient : ingredients) {
+            if (!readString(ingredient_ids, dictionary_, ingredient)) {
+                return false;
+            }
+        }
+
+        int style;
+        int64_t level;
+        uint8_t flag;
+        Dish* dish = nullptr;
+        bool build = row >= skip;
+        if (kind == APPETIZER) {
+            if (!readEnum(attributes, Appetizer::BUFFET + 1, style) || !attributes.signedVarint(level)
+                || !attributes.byte(flag)) {
+                return false;
+            }
+            if (build) {
+                dish = new Appetizer(std::move(name), std::move(ingredients), int(prep_time), Money::fromCents(cents),
+                    cuisine, Appetizer::ServingStyle(style), int(level), flag != 0);
+            }
+        } else if (kind == DESSERT) {
+            if (!readEnum(attributes, Dessert::UMAMI + 1, style) || !attributes.signedVarint(level)
+                || !attributes.byte(flag)) {
+                return false;
+            }
+            if (build) {
+                dish = new Dessert(std::move(name), std::move(ingredients), int(prep_time), Money::fromCents(cents),
+                    cuisine, Dessert::FlavorProfile(style), int(level), flag != 0);
+            }
+        } else {
+            uint64_t side_count;
+            if (!readEnum(attributes, MainCourse::RAW + 1, style) || !readString(attributes, dictionary_, text)
+                || !attributes.varint(side_count) || side_count > spans[ATTRIBUTES].size()) {
+                return false;
+            }
+            std::vector<MainCourse::SideDish> sides(side_count);
+            for (MainCourse::SideDish& side : sides) {
+                int category;
+                if (!readString(attributes, dictionary_, side.name)
+                    || !readEnum(attributes, MainCourse::VEGETABLE + 1, category)) {
+                    return false;
+                }
+                side.category = MainCourse::Category(category);
+            }
+            if (!attributes.byte(flag)) {
+                return false;
+            }
+            if (build) {
+                dish = new MainCourse(std::move(name), std::move(ingredients), int(prep_time), Money::fromCents(cents),
+                    cuisine, MainCourse::CookingMethod(style), std::move(text), std::move(sides),
+                    flag != 0);
+            }
+        }
+        if (dish != nullptr) {
+            dishes.push_back(dish);
+            if (cuisine_names != nullptr) {
+                cuisine_names->push_back(cuisine_name);
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Decodes a range of rows, reading only the blocks that hold them.
+ * @return False if a block is corrupt; the dishes decoded so far are kept.
+ */
+bool MenuArchiveReader::readRows(const uint64_t& first, const uint64_t& count, std::vector<Dish*>& dishes,
+    std::vector<std::string>* cuisine_names) {
+    uint64_t end = count > row_count_ - std::min(first, row_count_) ? row_count_ : first + count;
+    for (size_t b = 0; b < blocks_.size(); b++) {
+        const BlockInfo& block = blocks_[b];
+        if (block.first_row + block.rows <= first) {
+            continue;
+        }
+        if (block.first_row >= end) {
+            break;
+        }
+        uint64_t skip = first > block.first_row ? first - block.first_row : 0;
+        if (!readBlock(b, skip, end - block.first_row - skip, dishes, cuisine_names)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Streams a range of rows into a kitchen one block at a time.
+ * @return The number of dishes added, or -1 if a block is corrupt.
+ */
+int MenuArchiveReader::loadInto(Kitchen& kitchen, const uint64_t& first, const uint64_t& count) {
+    uint64_t end = count > row_count_ - std::min(first, row_count_) ? row_count_ : first + count;
+    int added = 0;
+    std::vector<Dish*> dishes;
+    for (size_t b = 0; b < blocks_.size(); b++) {
+        const BlockInfo& block = blocks_[b];
+        if (block.first_row + block.rows <= first) {
+            continue;
+        }
+        if (block.first_row >= end) {
+            break;
+        }
+        uint64_t skip = first > block.first_row ? first - block.first_row : 0;
+        dishes.clear();
+        bool ok = readBlock(b, skip, end - block.first_row - skip, dishes, nullptr);
+        std::vector<bool> accepted = kitchen.newOrders(dishes);
+        bool full = false;
+        for (size_t i = 0; i < dishes.size(); i++) {
+            if (accepted[i]) {
+                kitchen.adoptDish(dishes[i]);
+                added++;
+            } else {
+                delete dishes[i];
+                full = true;
+            }
+        }
+        if (!ok) {
+            return -1;
+        }
+        if (full) {
+            break;
+        }
+    }
+    return added;
+}
@@ -0,0 +1,179 @@
+#ifndef MENU_ARCHIVE_HPP
+#define MENU_ARCHIVE_HPP
+
+#include "Dish.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class Kitchen;
+
+/**
+ * @class MenuArchiveWriter
+ * @brief Writes dishes to a compact columnar archive, e.g. years of menu
+ * versions or served orders that would otherwise be kept as Dishes.csv rows.
+ *
+ * The file is a sequence of blocks of up to `block_rows` dishes, then a
+ * string dictionary, a block index and a fixed-size footer:
+ * - Every string (dish names, cuisines, ingredients, protein types and side
+ *   dishes) is stored once in the dictionary and referred to by a varint ID.
+ *   Cuisines are kept as the menu wrote them, so names without a
+ *   Dish::CuisineType, such as JAPANESE, survive a round trip. Dish types
+ *   and the other enums are stored as one byte each.
+ * - Within a block each field is a separate column. Prep times and prices
+ *   (in cents) are zigzag varints of the difference from the previous row,
+ *   so repeated and nearby values take one byte.
+ * - Each block and the dictionary are compressed with zlib on their own.
+ *   The index records where each block is and which rows it holds, so a
+ *   range of rows is read by inflating only the blocks that hold it.
+ * Deltas restart in every block, so any block decodes on its own.
+ */
+class MenuArchiveWriter {
+public:
+    static const size_t DEFAULT_BLOCK_ROWS = 4096;
+
+    /**
+     * @param filename The archive to create; an existing file is replaced.
+     * @param block_rows The number of dishes per block.
+     */
+    explicit MenuArchiveWriter(const std::string& filename, const size_t& block_rows = DEFAULT_BLOCK_ROWS);
+
+    /**
+     * @return True if the file could be opened and nothing has failed since.
+     */
+    bool isOpen() const;
+
+    /**
+     * Appends a dish. The writer keeps no reference to it.
+     * @param cuisine_name The cuisine as the menu wrote it, e.g. from
+     `DishCsv::cuisineName()`; if empty, the dish's own cuisine type.
+     * @return False if the archive is not open or a block could not be written.
+     */
+    bool add(const Dish* dish, const std::string& cuisine_name = "");
+
+    /**
+     * Writes the last block, the dictionary, the index and the footer.
+     * Must be called for the archive to be readable.
+     * @return True if the whole archive was written.
+     */
+    bool close();
+
+    /**
+     * @return The number of dishes added.
+     */
+    uint64_t rowCount() const;
+
+    /**
+     * @return The bytes written to the file so far, the whole archive after `close()`.
+     */
+    uint64_t fileSize() const;
+
+private:
+    struct BlockInfo {
+        uint64_t compressed_size;
+        uint64_t raw_size;
+        uint64_t rows;
+    };
+
+    std::ofstream file_;
+    bool ok_;
+    size_t block_rows_;
+    uint64_t offset_;
+    uint64_t row_count_;
+    std::vector<BlockInfo> blocks_;
+    std::vector<std::string> dictionary_;
+    std::unordered_map<std::string, uint64_t> dictionary_ids_;
+
+    // The columns of the current block.
+    static const int COLUMN_COUNT = 7;
+    std::string columns_[COLUMN_COUNT];
+    uint64_t block_size_;
+    int64_t previous_prep_time_;
+    int64_t previous_cents_;
+
+    /**
+     * @return The dictionary ID of a string, adding it if it is new.
+     */
+    uint64_t stringId(const std::string_view& text);
+
+    /**
+     * Compresses a buffer and appends it to the file.
+     * @param compressed_size Set to the number of bytes written.
+     */
+    bool writeCompressed(const std::string& raw, uint64_t& compressed_size);
+
+    bool flushBlock();
+};
+
+/**
+ * @class MenuArchiveReader
+ * @brief Reads dishes back from an archive written by MenuArchiveWriter.
+ *
+ * `open()` reads only the footer, the index and the dictionary; blocks are
+ * read and inflated when their rows are asked for.
+ */
+class MenuArchiveReader {
+public:
+    MenuArchiveReader();
+
+    /**
+     * @return False if the file could not be read or is not a complete archive.
+     */
+    bool open(const std::string& filename);
+
+    uint64_t rowCount() const;
+    size_t blockCount() const;
+
+    /**
+     * Decodes a range of rows, reading only the blocks that hold them.
+     * @param first The first row, 0-based.
+     * @param count The maximum number of rows; the range is clipped to the archive.
+     * @param dishes Receives newly allocated dishes, which the caller owns.
+     * @param cuisine_names If not nullptr, receives the cuisine of each dish as
+     the menu wrote it, for `DishCsv::formatRow()`.
+     * @return False if a block is corrupt; the dishes decoded so far are kept.
+     */
+    bool readRows(const uint64_t& first, const uint64_t& count, std::vector<Dish*>& dishes,
+        std::vector<std::string>* cuisine_names = nullptr);
+
+    /**
+     * Streams a range of rows into a kitchen one block at a time with
+     * `Kitchen::newOrders()`, stopping once the kitchen rejects a dish.
+     * @param first The first row, 0-based.
+     * @param count The maximum number of rows.
+     * @return The number of dishes added, or -1 if a block is corrupt.
+     * @post The kitchen adopts the added dishes (see `Kitchen::adoptDish()`); the others are deleted.
+     */
+    int loadInto(Kitchen& kitchen, const uint64_t& first = 0, const uint64_t& count = UINT64_MAX);
+
+private:
+    struct BlockInfo {
+        uint64_t offset;
+        uint64_t compressed_size;
+        uint64_t raw_size;
+        uint64_t first_row;
+        uint64_t rows;
+    };
+
+    std::ifstream file_;
+    std::vector<std::string> dictionary_;
+    std::vector<BlockInfo> blocks_;
+    uint64_t row_count_;
+
+    /**
+     * Reads and inflates `size` bytes at `offset` into `raw_size` bytes.
+     */
+    bool readCompressed(const uint64_t& offset, const uint64_t& size, const uint64_t& raw_size, std::string& raw);
+
+    /**
+     * Decodes rows [skip, skip + limit) of a block.
+     * @param cuisine_names If not nullptr, receives the cuisine of each dish as written.
+     */
+    bool readBlock(const size_t& block, const uint64_t& skip, const uint64_t& limit, std::vector<Dish*>& dishes,
+        std::vector<std::string>* cuisine_names);
+};
+
+#endif // MENU_ARCHIVE_HPP
@@ -0,0 +1,157 @@
+#include "MenuDiff.hpp"
+#include "DishCsv.hpp"
+#include <fstream>
+#include <unordered_map>
+
+namespace {
+
+/**
+ * A parsed menu row: the dish's name and its binary encoding, which covers
+ * every field the row describes.
+ */
+struct MenuEntry {
+    std::string name;
+    std::string content;
+    size_t row = 0;
+    int next = -1;          // the next entry with the same name
+    bool matched = false;
+};
+
+/**
+ * @return False if the row does not parse.
+ */
+bool parseEntry(const std::string& row, const size_t& index, MenuEntry& entry) {
+    Dish* dish = DishCsv::parseRow(row);
+    if (dish == nullptr) {
+        return false;
+    }
+    entry.name = dish->getName();
+    entry.content.clear();
+    dish->serialize(Serializable::BINARY, entry.content);
+    entry.row = index;
+    delete dish;
+    return true;
+}
+
+} // namespace
+
+/**
+ * @param buffer Receives the edit as text, newline included.
+ */
+void MenuEdit::format(std::string& buffer) const {
+    switch (kind) {
+        case ADD:
+            buffer += "+ ";
+            buffer += after;
+            break;
+        case REMOVE:
+            buffer += "- ";
+            buffer += before;
+            break;
+        case CHANGE:
+            buffer += "~ ";
+            buffer += before;
+            buffer += "\n> ";
+            buffer += after;
+            break;
+    }
+    buffer += '\n';
+}
+
+/**
+ * Diffs two menus in time linear in their size.
+ * @param edits Receives the removals in old menu order, then the changes
+ and additions in new menu order.
+ */
+void MenuDiff::diff(const std::vector<std::string>& before, const std::vector<std::string>& after,
+    std::vector<MenuEdit>& edits) {
+    std::vector<MenuEntry> entries;
+    entries.reserve(before.size());
+    // first and last entry of each name, so repeated names pair up in order
+    std::unordered_map<std::string, std::pair<int, int>> by_name;
+    by_name.reserve(before.size());
+    MenuEntry entry;
+    for (size_t i = 0; i < before.size(); i++) {
+        if (!parseEntry(before[i], i, entry)) {
+            continue;
+        }
+        int index = int(entries.size());
+        auto inserted = by_name.emplace(entry.name, std::make_pair(index, index));
+        if (!inserted.second) {
+            entries[inserted.first->second.second].next = index;
+            inserted.first->second.second = index;
+        }
+        entries.push_back(std::move(entry));
+    }
+
+    std::vector<MenuEdit> changes;
+    for (size_t i = 0; i < after.size(); i++) {
+        if (!parseEntry(after[i], i, entry)) {
+            continue;
+        }
+        auto found = by_name.find(entry.name);
+        if (found == by_name.end() || found->second.first < 0) {
+            MenuEdit edit;
+            edit.kind = MenuEdit::ADD;
+            edit.after = after[i];
+            changes.push_back(std::move(edit));
+            continue;
+        }
+        MenuEntry& old_entry = entries[found->second.first];
+        found->second.first = old_entry.next;
+        old_entry.matched = true;
+        if (old_entry.content != entry.content) {
+            MenuEdit edit;
+            edit.kind = MenuEdit::CHANGE;
+            edit.before = before[old_entry.row];
+            edit.after = after[i];
+            changes.push_back(std::move(edit));
+        }
+    }
+
+    for (const MenuEntry& old_entry : entries) {
+        if (!old_entry.matched) {
+            MenuEdit edit;
+            edit.kind = MenuEdit::REMOVE;
+            edit.before = before[old_entry.row];
+            edits.push_back(std::move(edit));
+        }
+    }
+    for (MenuEdit& edit : changes) {
+        edits.push_back(std::move(edit));
+    }
+}
+
+/**
+ * Diffs two menu files in the `Dishes.csv` format.
+ * @return False if either file could not be read.
+ */
+bool MenuDiff::diffFiles(const std::string& before_file, const std::string& after_file, std::vector<MenuEdit>& edits) {
+    std::vector<std::string> before;
+    std::vector<std::string> after;
+    if (!readRows(before_file, before) || !readRows(after_file, after)) {
+        return false;
+    }
+    diff(before, after, edits);
+    return true;
+}
+
+/**
+ * @param filename A menu file; its header line is skipped.
+ * @param rows Receives the data rows.
+ * @return False if the file could not be read.
+ */
+bool MenuDiff::readRows(const std::string& filename, std::vector<std::string>& rows) {
+    std::ifstream file(filename);
+    std::string row;
+    if (!std::getline(file, row)) {
+        return false;
+    }
+    while (std::getline(file, row)) {
+        if (!row.empty() && row.back() == '\r') {
+            row.pop_back();
+        }
+        rows.push_back(std::move(row));
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef MENU_DIFF_HPP
+#define MENU_DIFF_HPP
+
+#include <string>
+#include <vector>
+
+/**
+ * @struct MenuEdit
+ * @brief One step of the edit script that turns one menu into another.
+ *
+ * Dishes are carried as rows in the `Dishes.csv` format (see DishCsv), so a
+ * script can be printed, stored and applied to a kitchen without the menus
+ * it came from.
+ */
+struct MenuEdit {
+    enum Kind { ADD, REMOVE, CHANGE };
+
+    Kind kind = ADD;
+    std::string before;  ///< The row in the old menu; empty for ADD.
+    std::string after;   ///< The row in the new menu; empty for REMOVE.
+
+    /**
+     * @param buffer Receives the edit as text, newline included:
+     * `+ row` for ADD, `- row` for REMOVE, and `~ before` followed by
+     `> after` on the next line for CHANGE.
+     */
+    void format(std::string& buffer) const;
+};
+
+/**
+ * @class MenuDiff
+ * @brief Compares two menus and produces the edit script between them.
+ *
+ * Dishes are matched by name, the first of a repeated name in one menu with
+ * the first in the other. A matched pair is a CHANGE if the dishes differ in
+ * anything the menu row describes: the fields of `Dish::operator==`, the
+ * ingredients or the attributes of the dish type. Rows that do not parse are
+ * ignored, as `Kitchen(filename)` ignores them.
+ */
+class MenuDiff {
+public:
+    /**
+     * Diffs two menus in time linear in their size: the old dishes are
+     * hashed by name, and each new dish is looked up once.
+     * @param before The data rows of the old menu, without the header.
+     * @param after The data rows of the new menu, without the header.
+     * @param edits Receives the removals in old menu order, then the changes
+     and additions in new menu order.
+     */
+    static void diff(const std::vector<std::string>& before, const std::vector<std::string>& after,
+        std::vector<MenuEdit>& edits);
+
+    /**
+     * Diffs two menu files in the `Dishes.csv` format.
+     * @return False if either file could not be read.
+     */
+    static bool diffFiles(const std::string& before_file, const std::string& after_file, std::vector<MenuEdit>& edits);
+
+    /**
+     * @param filename A menu file; its header line is skipped.
+     * @param rows Receives the data rows.
+     * @return False if the file could not be read.
+     */
+    static bool readRows(const std::string& filename, std::vector<std::string>& rows);
+};
+
+#endif // MENU_DIFF_HPP
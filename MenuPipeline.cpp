@@ -0,0 +1,182 @@
+#include "MenuPipeline.hpp"
+#include "DishCsv.hpp"
+#include <fstream>
+#include <thread>
+
+/**
+ * @param kitchen The kitchen to order the dishes into; it adopts them (see `Kitchen::adoptDish()`).
+ * @param options How to run.
+ */
+MenuPipeline::MenuPipeline(Kitchen& kitchen, const Options& options)
+    : kitchen_(kitchen), options_(options), cancelled_(false), ordered_(0), kitchen_full_(false),
+      lines_(options.channel_capacity), parsed_(options.channel_capacity),
+      adjusted_(options.channel_capacity), ordered_dishes_(options.channel_capacity) {
+    if (options_.chunk_rows < 1) {
+        options_.chunk_rows = 1;
+    }
+}
+
+/**
+ * Runs the pipeline on a menu file and waits for it to finish.
+ * @param filename A file in the Dishes.csv format.
+ * @return False if the file could not be opened or the run was cancelled.
+ */
+bool MenuPipeline::run(const std::string& filename) {
+    std::ifstream input(filename);
+    if (!input) {
+        return false;
+    }
+    std::thread parser(&MenuPipeline::parseStage, this);
+    std::thread adjuster(&MenuPipeline::adjustStage, this);
+    std::thread orderer(&MenuPipeline::orderStage, this);
+    std::thread publisher(&MenuPipeline::publishStage, this);
+    readStage(input);
+    parser.join();
+    adjuster.join();
+    orderer.join();
+    publisher.join();
+
+    // after a cancellation, chunks can be left between stages
+    Lines lines;
+    while (lines_.tryPop(lines)) {
+    }
+    Dishes dishes;
+    while (parsed_.tryPop(dishes)) {
+        discard(dishes);
+    }
+    while (adjusted_.tryPop(dishes)) {
+        discard(dishes);
+    }
+    while (ordered_dishes_.tryPop(dishes)) {
+        // already owned by the kitchen
+    }
+    return !cancelled_.load();
+}
+
+/**
+ * Stops a running pipeline from any thread.
+ */
+void MenuPipeline::cancel() {
+    cancelled_.store(true);
+    lines_.cancel();
+    parsed_.cancel();
+    adjusted_.cancel();
+    ordered_dishes_.cancel();
+}
+
+/**
+ * @return The number of dishes ordered into the kitchen so far.
+ */
+int MenuPipeline::orderedCount() const {
+    return ordered_.load();
+}
+
+void MenuPipeline::readStage(std::istream& input) {
+    std::string row;
+    std::getline(input, row); // skip the header
+    Lines lines;
+    while (!cancelled_.load() && !kitchen_full_.load() && std::getline(input, row)) {
+        lines.push_back(std::move(row));
+        if (lines.size() == options_.chunk_rows) {
+            if (!lines_.push(std::move(lines))) {
+                break;
+            }
+            lines = Lines();
+        }
+    }
+    if (!lines.empty()) {
+        lines_.push(std::move(lines));
+    }
+    lines_.close();
+}
+
+void MenuPipeline::parseStage() {
+    Lines lines;
+    while (lines_.pop(lines)) {
+        if (kitchen_full_.load()) {
+            continue;
+        }
+        Dishes dishes;
+        dishes.reserve(lines.size());
+        for (const std::string& row : lines) {
+            Dish* dish = DishCsv::parseRow(row);
+            if (dish != nullptr) {
+                dishes.push_back(dish);
+            }
+        }
+        forward(parsed_, std::move(dishes));
+    }
+    parsed_.close();
+}
+
+void MenuPipeline::adjustStage() {
+    Dishes dishes;
+    while (parsed_.pop(dishes)) {
+        if (kitchen_full_.load()) {
+            discard(dishes);
+            continue;
+        }
+        for (Dish* dish : dishes) {
+            if (options_.adjust) {
+                dish->dietaryAccommodations(options_.request);
+            }
+            if (options_.output != nullptr) {
+                dish->getRendered(); // render here, in parallel with ordering
+            }
+        }
+        forward(adjusted_, std::move(dishes));
+    }
+    adjusted_.close();
+}
+
+void MenuPipeline::orderStage() {
+    Dishes dishes;
+    while (adjusted_.pop(dishes)) {
+        Dishes accepted;
+        accepted.reserve(dishes.size());
+        std::vector<bool> added = kitchen_.newOrders(dishes);
+        for (size_t i = 0; i < dishes.size(); i++) {
+            if (added[i]) {
+                kitchen_.adoptDish(dishes[i]);
+                accepted.push_back(dishes[i]);
+            } else {
+                kitchen_full_.store(true);
+                delete dishes[i];
+            }
+        }
+        ordered_.fetch_add(int(accepted.size()));
+        if (options_.output != nullptr) {
+            ordered_dishes_.push(std::move(accepted));
+        }
+    }
+    ordered_dishes_.close();
+}
+
+void MenuPipeline::publishStage() {
+    Dishes dishes;
+    while (ordered_dishes_.pop(dishes)) {
+        for (const Dish* dish : dishes) {
+            *options_.output << dish->getRendered();
+        }
+        options_.output->flush();
+    }
+}
+
+/**
+ * Hands a chunk to the next stage, deleting its dishes if the pipeline was cancelled.
+ */
+void MenuPipeline::forward(Channel<Dishes>& channel, Dishes&& dishes) {
+    if (!channel.push(std::move(dishes))) {
+        discard(dishes);
+    }
+}
+
+/**
+ * Deletes dishes that never reached the kitchen.
+ */
+void MenuPipeline::discard(Dishes& dishes) {
+    for (Dish* dish : dishes) {
+        delete dish;
+    }
+    dishes.clear();
+}
@@ -0,0 +1,104 @@
+#ifndef MENU_PIPELINE_HPP
+#define MENU_PIPELINE_HPP
+
+#include "Channel.hpp"
+#include "Dish.hpp"
+#include "Kitchen.hpp"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @class MenuPipeline
+ * @brief Loads a menu file into a kitchen as a pipeline of concurrent stages.
+ *
+ * The serial sequence of reading the CSV, constructing dishes, `newOrder()`,
+ * `dietaryAdjustment()` and `displayMenu()` becomes five threads joined by
+ * bounded channels of row chunks:
+ * read lines -> parse dishes -> adjust and render -> order -> publish.
+ * Each chunk moves on as soon as a stage is done with it, so output for the
+ * first chunk appears after roughly one chunk's worth of work, while later
+ * chunks are still being read. A full channel blocks the stage feeding it.
+ *
+ * The kitchen only rejects dishes when it is full, and nothing leaves it
+ * during a run, so once an order fails the remaining rows are not read.
+ *
+ * Each chunk is owned by exactly one stage at a time, so dishes need no
+ * locking. The kitchen is only touched by the order stage and must not be
+ * used by anyone else until `run()` returns.
+ */
+class MenuPipeline {
+public:
+    /**
+     * @struct Options
+     * @brief Tuning and behaviour of a run.
+     */
+    struct Options {
+        size_t chunk_rows = 64;         ///< Rows per chunk.
+        size_t channel_capacity = 4;    ///< Chunks each channel holds before its producer blocks.
+        bool adjust = false;            ///< Apply `request` to every dish before ordering it.
+        Dish::DietaryRequest request = {};
+        std::ostream* output = &std::cout; ///< Receives each ordered dish's display text; nullptr for none.
+    };
+
+    /**
+     * @param kitchen The kitchen to order the dishes into; it adopts them (see `Kitchen::adoptDish()`).
+     * @param options How to run.
+     */
+    MenuPipeline(Kitchen& kitchen, const Options& options);
+
+    MenuPipeline(const MenuPipeline&) = delete;
+    MenuPipeline& operator=(const MenuPipeline&) = delete;
+
+    /**
+     * Runs the pipeline on a menu file and waits for it to finish. A pipeline runs once.
+     * Dishes the kitchen rejects (it is full) are deleted, and reading stops.
+     * @param filename A file in the Dishes.csv format.
+     * @return False if the file could not be opened or the run was cancelled.
+     */
+    bool run(const std::string& filename);
+
+    /**
+     * Stops a running pipeline from any thread. Dishes already ordered stay
+     in the kitchen; the others are deleted.
+     */
+    void cancel();
+
+    /**
+     * @return The number of dishes ordered into the kitchen so far.
+     */
+    int orderedCount() const;
+
+private:
+    typedef std::vector<std::string> Lines;
+    typedef std::vector<Dish*> Dishes;
+
+    Kitchen& kitchen_;
+    Options options_;
+    std::atomic<bool> cancelled_;
+    std::atomic<int> ordered_;
+    std::atomic<bool> kitchen_full_; // set by the order stage once newOrder() fails
+    Channel<Lines> lines_;
+    Channel<Dishes> parsed_;
+    Channel<Dishes> adjusted_;
+    Channel<Dishes> ordered_dishes_;
+
+    void readStage(std::istream& input);
+    void parseStage();
+    void adjustStage();
+    void orderStage();
+    void publishStage();
+
+    /**
+     * Hands a chunk to the next stage, deleting its dishes if the pipeline was cancelled.
+     */
+    void forward(Channel<Dishes>& channel, Dishes&& dishes);
+
+    /**
+     * Deletes dishes that never reached the kitchen.
+     */
+    static void discard(Dishes& dishes);
+};
+
+#endif // MENU_PIPELINE_HPP
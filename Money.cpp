@@ -0,0 +1,135 @@
+#include "Money.hpp"
+#include <cctype>
+#include <cmath>
+
+/**
+ * Default constructor.
+ * Initializes the amount to $0.00.
+ */
+Money::Money() : cents_(0) {
+}
+
+/**
+ * Converting constructor.
+ * @param amount An amount in dollars, rounded to the nearest cent.
+ */
+Money::Money(const double& amount) : cents_(std::llround(amount * 100)) {
+}
+
+Money Money::fromCents(const int64_t& cents) {
+    Money money;
+    money.cents_ = cents;
+    return money;
+}
+
+bool Money::parse(const std::string& text, Money& money) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+        negative = text[i] == '-';
+        i++;
+    }
+    if (i < text.size() && text[i] == '$') {
+        i++;
+    }
+    int64_t dollars = 0;
+    int digits = 0;
+    while (i < text.size() && std::isdigit((unsigned char)text[i])) {
+        dollars = dollars * 10 + (text[i] - '0');
+        digits++;
+        i++;
+    }
+    int64_t cents = 0;
+    if (i < text.size() && text[i] == '.') {
+        i++;
+        int places = 0;
+        while (i < text.size() && std::isdigit((unsigned char)text[i])) {
+            if (places < 2) {
+                cents = cents * 10 + (text[i] - '0');
+            } else if (places == 2 && text[i] >= '5') {
+                cents++; // round half up on the first dropped digit
+            }
+            places++;
+            digits++;
+            i++;
+        }
+        if (places == 1) {
+            cents *= 10;
+        }
+    }
+    if (digits == 0 || i != text.size()) {
+        return false;
+    }
+    int64_t total = dollars * 100 + cents;
+    money.cents_ = negative ? -total : total;
+    return true;
+}
+
+int64_t Money::getCents() const {
+    return cents_;
+}
+
+double Money::toDouble() const {
+    return cents_ / 100.0;
+}
+
+std::string Money::toString() const {
+    int64_t magnitude = cents_ < 0 ? -cents_ : cents_;
+    std::string text = (cents_ < 0 ? "-" : "") + std::to_string(magnitude / 100) + ".";
+    int64_t cents = magnitude % 100;
+    if (cents < 10) {
+        text += "0";
+    }
+    return text + std::to_string(cents);
+}
+
+Money Money::operator+(const Money& rhs) const {
+    return fromCents(cents_ + rhs.cents_);
+}
+
+Money Money::operator-(const Money& rhs) const {
+    return fromCents(cents_ - rhs.cents_);
+}
+
+Money& Money::operator+=(const Money& rhs) {
+    cents_ += rhs.cents_;
+    return *this;
+}
+
+Money& Money::operator-=(const Money& rhs) {
+    cents_ -= rhs.cents_;
+    return *this;
+}
+
+Money Money::dividedBy(const int64_t& divisor) const {
+    int64_t half = divisor / 2;
+    return fromCents((cents_ < 0 ? cents_ - half : cents_ + half) / divisor);
+}
+
+bool Money::operator==(const Money& rhs) const {
+    return cents_ == rhs.cents_;
+}
+
+bool Money::operator!=(const Money& rhs) const {
+    return cents_ != rhs.cents_;
+}
+
+bool Money::operator<(const Money& rhs) const {
+    return cents_ < rhs.cents_;
+}
+
+bool Money::operator>(const Money& rhs) const {
+    return cents_ > rhs.cents_;
+}
+
+bool Money::operator<=(const Money& rhs) const {
+    return cents_ <= rhs.cents_;
+}
+
+bool Money::operator>=(const Money& rhs) const {
+    return cents_ >= rhs.cents_;
+}
+
+std::ostream& operator<<(std::ostream& out, const Money& money) {
+    return out << money.toString();
+}
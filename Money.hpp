@@ -0,0 +1,86 @@
+#ifndef MONEY_HPP
+#define MONEY_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/**
+ * @class Money
+ * @brief A fixed-point amount of money stored as a whole number of cents.
+ *
+ * Sums of Money are exact and independent of the order in which they are
+ * added, unlike sums of `double` prices.
+ */
+class Money {
+public:
+    /**
+     * Default constructor.
+     * Initializes the amount to $0.00.
+     */
+    Money();
+
+    /**
+     * Converting constructor, so prices can still be written as literals such as 7.50.
+     * @param amount An amount in dollars, rounded to the nearest cent.
+     */
+    Money(const double& amount);
+
+    /**
+     * @param cents An amount in cents.
+     * @return The amount as Money.
+     */
+    static Money fromCents(const int64_t& cents);
+
+    /**
+     * Parses a decimal amount such as "12.99", "$4" or "-0.5" without going through floating point.
+     * Digits beyond the cents are rounded half up.
+     * @param text The text to parse.
+     * @param money Set to the parsed amount on success.
+     * @return True if `text` is a valid amount, false otherwise.
+     */
+    static bool parse(const std::string& text, Money& money);
+
+    /**
+     * @return The amount in cents.
+     */
+    int64_t getCents() const;
+
+    /**
+     * @return The amount in dollars, for interfaces that need a double.
+     */
+    double toDouble() const;
+
+    /**
+     * @return The amount formatted with two decimal places, e.g. "12.99".
+     */
+    std::string toString() const;
+
+    Money operator+(const Money& rhs) const;
+    Money operator-(const Money& rhs) const;
+    Money& operator+=(const Money& rhs);
+    Money& operator-=(const Money& rhs);
+
+    /**
+     * @param divisor The number of equal parts, must be positive.
+     * @return The amount divided into `divisor` parts, rounded half away from zero to the cent.
+     */
+    Money dividedBy(const int64_t& divisor) const;
+
+    bool operator==(const Money& rhs) const;
+    bool operator!=(const Money& rhs) const;
+    bool operator<(const Money& rhs) const;
+    bool operator>(const Money& rhs) const;
+    bool operator<=(const Money& rhs) const;
+    bool operator>=(const Money& rhs) const;
+
+private:
+    int64_t cents_;
+};
+
+/**
+ * Writes the amount as `Money::toString()` does, without a currency sign.
+ */
+std::ostream& operator<<(std::ostream& out, const Money& money);
+
+#endif // MONEY_HPP
@@ -0,0 +1,73 @@
+#include "OrderTrace.hpp"
+
+#include <charconv>
+
+namespace {
+
+const char* const KIND_NAMES[] = { "ORDER", "SERVE", "RELEASE_PREP", "RELEASE_CUISINE", "DIETARY", "REPORT" };
+
+bool parseInteger(const char* first, const char* last, int64_t& value) {
+    std::from_chars_result result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+void appendInteger(std::string& buffer, const int64_t& value) {
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr);
+}
+
+} // namespace
+
+const char* const OrderEvent::HEADER = "TimeMicros,Event,Argument";
+
+/**
+ * @param line A line of a trace file, without the trailing newline.
+ * @param event Set to the parsed event on success.
+ * @return True if the line is a valid event, false otherwise (including the header).
+ */
+bool OrderEvent::parse(const std::string& line, OrderEvent& event) {
+    size_t end = line.size();
+    if (end != 0 && line[end - 1] == '\r') {
+        end--;
+    }
+    size_t first = line.find(',');
+    size_t second = first == std::string::npos ? first : line.find(',', first + 1);
+    if (second == std::string::npos || second >= end) {
+        return false;
+    }
+    if (!parseInteger(line.data(), line.data() + first, event.time_us)) {
+        return false;
+    }
+    std::string kind = line.substr(first + 1, second - first - 1);
+    for (int k = ORDER; k <= REPORT; k++) {
+        if (kind != KIND_NAMES[k]) {
+            continue;
+        }
+        event.kind = Kind(k);
+        if (event.kind == RELEASE_CUISINE) {
+            event.cuisine = line.substr(second + 1, end - second - 1);
+            event.argument = 0;
+            return !event.cuisine.empty();
+        }
+        event.cuisine.clear();
+        return parseInteger(line.data() + second + 1, line.data() + end, event.argument);
+    }
+    return false;
+}
+
+/**
+ * @param buffer Receives the event as a trace line, newline included.
+ */
+void OrderEvent::format(std::string& buffer) const {
+    appendInteger(buffer, time_us);
+    buffer.push_back(',');
+    buffer.append(KIND_NAMES[kind]);
+    buffer.push_back(',');
+    if (kind == RELEASE_CUISINE) {
+        buffer.append(cuisine);
+    } else {
+        appendInteger(buffer, argument);
+    }
+    buffer.push_back('\n');
+}
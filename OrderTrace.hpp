@@ -0,0 +1,44 @@
+#ifndef ORDER_TRACE_HPP
+#define ORDER_TRACE_HPP
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @struct OrderEvent
+ * @brief One timed operation on a kitchen, as recorded in an order trace.
+ *
+ * A trace is a text file with a header line and one event per line:
+ * `time_us,KIND,argument`, where time_us is the intended start time in
+ * microseconds from the start of the trace and the argument depends on KIND:
+ * - ORDER, SERVE: the 0-based row of the dish in the menu file the trace was made for
+ * - RELEASE_PREP: a preparation time in minutes, see `Kitchen::releaseDishesBelowPrepTime()`
+ * - RELEASE_CUISINE: a cuisine type name, see `Kitchen::releaseDishesOfCuisineType()`
+ * - DIETARY: the request flags as a bitmask in DietaryRequest field order
+ (1 = vegetarian, 2 = vegan, 4 = gluten_free, 8 = nut_free, 16 = low_sodium, 32 = low_sugar)
+ * - REPORT: unused, 0; see `Kitchen::kitchenReport()`
+ */
+struct OrderEvent {
+    enum Kind { ORDER, SERVE, RELEASE_PREP, RELEASE_CUISINE, DIETARY, REPORT };
+
+    int64_t time_us = 0;
+    Kind kind = ORDER;
+    int64_t argument = 0;   // row, minutes or flags
+    std::string cuisine;    // RELEASE_CUISINE only
+
+    static const char* const HEADER;
+
+    /**
+     * @param line A line of a trace file, without the trailing newline.
+     * @param event Set to the parsed event on success.
+     * @return True if the line is a valid event, false otherwise (including the header).
+     */
+    static bool parse(const std::string& line, OrderEvent& event);
+
+    /**
+     * @param buffer Receives the event as a trace line, newline included.
+     */
+    void format(std::string& buffer) const;
+};
+
+#endif // ORDER_TRACE_HPP
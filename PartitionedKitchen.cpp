@@ -0,0 +1,147 @@
+#include "PartitionedKitchen.hpp"
+
+namespace {
+
+// The calls below name the concrete type explicitly so they bind statically.
+
+template <class DishType>
+int prepTimeSum(const DishPartition<DishType>& partition)
+{
+    int sum = 0;
+    for (const DishType& dish : partition.getDishes())
+    {
+        sum += dish.getPrepTime();
+    }
+    return sum;
+}
+
+template <class DishType>
+int cuisineCount(const DishPartition<DishType>& partition, const std::string& cuisine_type)
+{
+    int count = 0;
+    for (const DishType& dish : partition.getDishes())
+    {
+        if (dish.getCuisineType() == cuisine_type)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+template <class DishType>
+void adjustAll(DishPartition<DishType>& partition, const Dish::DietaryRequest& request)
+{
+    for (DishType& dish : partition.getDishes())
+    {
+        dish.DishType::dietaryAccommodations(request);
+    }
+}
+
+template <class DishType>
+void displayAll(DishPartition<DishType>& partition)
+{
+    for (DishType& dish : partition.getDishes())
+    {
+        // as DishType::display(), without its virtual renderWith() call
+        std::cout << dish.template getRenderedAs<DishType>();
+    }
+}
+
+} // namespace
+
+PartitionedKitchen::PartitionedKitchen()
+{
+}
+
+/**
+* Moves a dish into its partition.
+* @param new_dish The dish to add.
+* @return A handle that refers to the dish until it is served.
+*/
+PartitionedKitchen::Handle PartitionedKitchen::newOrder(Appetizer&& new_dish)
+{
+    uint32_t slot = appetizers_.add(std::move(new_dish));
+    return { APPETIZER, slot, appetizers_.getGeneration(slot) };
+}
+
+PartitionedKitchen::Handle PartitionedKitchen::newOrder(MainCourse&& new_dish)
+{
+    uint32_t slot = main_courses_.add(std::move(new_dish));
+    return { MAIN_COURSE, slot, main_courses_.getGeneration(slot) };
+}
+
+PartitionedKitchen::Handle PartitionedKitchen::newOrder(Dessert&& new_dish)
+{
+    uint32_t slot = desserts_.add(std::move(new_dish));
+    return { DESSERT, slot, desserts_.getGeneration(slot) };
+}
+
+/**
+* Removes a dish from the kitchen.
+* @param dish_to_remove The handle returned by `newOrder()`.
+* @return True if the dish was removed, false if the handle is stale.
+*/
+bool PartitionedKitchen::serveDish(const Handle& dish_to_remove)
+{
+    switch (dish_to_remove.kind)
+    {
+        case APPETIZER: return appetizers_.remove(dish_to_remove.slot, dish_to_remove.generation);
+        case MAIN_COURSE: return main_courses_.remove(dish_to_remove.slot, dish_to_remove.generation);
+        case DESSERT: return desserts_.remove(dish_to_remove.slot, dish_to_remove.generation);
+    }
+    return false;
+}
+
+/**
+* @return The dish a handle refers to, or nullptr if the handle is stale.
+*/
+Dish* PartitionedKitchen::getDish(const Handle& handle)
+{
+    switch (handle.kind)
+    {
+        case APPETIZER: return appetizers_.get(handle.slot, handle.generation);
+        case MAIN_COURSE: return main_courses_.get(handle.slot, handle.generation);
+        case DESSERT: return desserts_.get(handle.slot, handle.generation);
+    }
+    return nullptr;
+}
+
+int PartitionedKitchen::getCurrentSize() const
+{
+    return appetizers_.getCurrentSize() + main_courses_.getCurrentSize() + desserts_.getCurrentSize();
+}
+
+int PartitionedKitchen::getPrepTimeSum() const
+{
+    return prepTimeSum(appetizers_) + prepTimeSum(main_courses_) + prepTimeSum(desserts_);
+}
+
+int PartitionedKitchen::tallyCuisineTypes(const std::string& cuisine_type) const
+{
+    return cuisineCount(appetizers_, cuisine_type) + cuisineCount(main_courses_, cuisine_type)
+        + cuisineCount(desserts_, cuisine_type);
+}
+
+/**
+* Adjusts all dishes in the kitchen based on the specified dietary accommodation.
+* @param request A DietaryRequest structure specifying the dietary accommodations.
+* @post Calls each dish's own `dietaryAccommodations()`, partition by partition.
+*/
+void PartitionedKitchen::dietaryAdjustment(const Dish::DietaryRequest& request)
+{
+    adjustAll(appetizers_, request);
+    adjustAll(main_courses_, request);
+    adjustAll(desserts_, request);
+}
+
+/**
+* Displays all dishes currently in the kitchen, appetizers first.
+* @post Calls each dish's own `display()`, partition by partition.
+*/
+void PartitionedKitchen::displayMenu()
+{
+    displayAll(appetizers_);
+    displayAll(main_courses_);
+    displayAll(desserts_);
+}
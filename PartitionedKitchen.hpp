@@ -0,0 +1,99 @@
+#ifndef PARTITIONED_KITCHEN_HPP
+#define PARTITIONED_KITCHEN_HPP
+
+#include "Appetizer.hpp"
+#include "Dessert.hpp"
+#include "DishPartition.hpp"
+#include "MainCourse.hpp"
+#include <string>
+
+/**
+ * @class PartitionedKitchen
+ * @brief Alternative kitchen storage that keeps each dish type by value in its own contiguous partition.
+ *
+ * Unlike Kitchen, which holds `Dish*` to separately allocated objects,
+ * dishes here are moved into one vector per concrete type. Kitchen-wide
+ * passes walk each partition in turn and call the concrete type's member
+ * functions directly, so there is no pointer chasing and the loops make no
+ * virtual calls of their own; those members may still dispatch internally,
+ * e.g. to `dietaryPlan()`. Dishes are addressed through stable handles because their
+ * position in a partition changes as other dishes are served.
+ */
+class PartitionedKitchen {
+    public:
+        /**
+        * @enum DishKind
+        * @brief The partition a handle refers to.
+        */
+        enum DishKind { APPETIZER, MAIN_COURSE, DESSERT };
+
+        /**
+        * @struct Handle
+        * @brief Stable reference to a dish stored in the kitchen.
+        */
+        struct Handle {
+            DishKind kind;
+            uint32_t slot;
+            uint32_t generation;
+        };
+
+        PartitionedKitchen();
+
+        /**
+        * Moves a dish into its partition.
+        * @param new_dish The dish to add.
+        * @return A handle that refers to the dish until it is served.
+        */
+        Handle newOrder(Appetizer&& new_dish);
+        Handle newOrder(MainCourse&& new_dish);
+        Handle newOrder(Dessert&& new_dish);
+
+        /**
+        * Removes a dish from the kitchen.
+        * @param dish_to_remove The handle returned by `newOrder()`.
+        * @return True if the dish was removed, false if the handle is stale.
+        */
+        bool serveDish(const Handle& dish_to_remove);
+
+        /**
+        * @return The dish a handle refers to, or nullptr if the handle is stale.
+        */
+        Dish* getDish(const Handle& handle);
+
+        /**
+        * @return The total number of dishes across all partitions.
+        */
+        int getCurrentSize() const;
+
+        /**
+        * @return The sum of the preparation times of all dishes.
+        */
+        int getPrepTimeSum() const;
+
+        /**
+        * @param cuisine_type The cuisine type to count, in string form.
+        * @return The number of dishes of the given cuisine type.
+        */
+        int tallyCuisineTypes(const std::string& cuisine_type) const;
+
+        /**
+        * Adjusts all dishes in the kitchen based on the specified dietary accommodation.
+        * @param request A DietaryRequest structure specifying the dietary accommodations.
+        * @post Calls each dish's own `dietaryAccommodations()`, partition by partition.
+        */
+        void dietaryAdjustment(const Dish::DietaryRequest& request);
+
+        /**
+        * Displays all dishes currently in the kitchen, appetizers first.
+        * @post Prints what each dish's `display()` would, partition by
+        partition, rendered with the concrete type's `renderWith()` called directly.
+        */
+        void displayMenu();
+
+    private:
+        DishPartition<Appetizer> appetizers_;
+        DishPartition<MainCourse> main_courses_;
+        DishPartition<Dessert> desserts_;
+};
+
+#endif // PARTITIONED_KITCHEN_HPP
@@ -0,0 +1,87 @@
+#include "Serializable.hpp"
+
+#include <charconv>
+
+/**
+ * @param buffer The buffer to append to. It must outlive the writer.
+ */
+SerialWriter::SerialWriter(std::string& buffer) : buffer_(buffer) {
+}
+
+void SerialWriter::text(const std::string_view& text) {
+    buffer_.append(text.data(), text.size());
+}
+
+void SerialWriter::character(const char& c) {
+    buffer_.push_back(c);
+}
+
+void SerialWriter::integer(const long long& value) {
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer_.append(digits, result.ptr);
+}
+
+void SerialWriter::decimal(const double& value) {
+    char digits[32];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer_.append(digits, result.ptr);
+}
+
+void SerialWriter::money(const Money& value) {
+    int64_t cents = value.getCents();
+    uint64_t magnitude = cents < 0 ? 0 - uint64_t(cents) : uint64_t(cents);
+    if (cents < 0) {
+        buffer_.push_back('-');
+    }
+    integer((long long)(magnitude / 100));
+    buffer_.push_back('.');
+    buffer_.push_back(char('0' + magnitude % 100 / 10));
+    buffer_.push_back(char('0' + magnitude % 10));
+}
+
+void SerialWriter::boolean(const bool& value) {
+    text(value ? "true" : "false");
+}
+
+/**
+ * Appends a quoted JSON string, escaping quotes, backslashes and control characters.
+ */
+void SerialWriter::jsonString(const std::string_view& text) {
+    static const char HEX[] = "0123456789abcdef";
+    buffer_.push_back('"');
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            buffer_.push_back('\\');
+            buffer_.push_back(c);
+        } else if ((unsigned char)c < 0x20) {
+            buffer_.append("\\u00");
+            buffer_.push_back(HEX[(unsigned char)c >> 4]);
+            buffer_.push_back(HEX[c & 0xf]);
+        } else {
+            buffer_.push_back(c);
+        }
+    }
+    buffer_.push_back('"');
+}
+
+void SerialWriter::byte(const uint8_t& value) {
+    buffer_.push_back(char(value));
+}
+
+void SerialWriter::varint(uint64_t value) {
+    while (value >= 0x80) {
+        buffer_.push_back(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    buffer_.push_back(char(value));
+}
+
+void SerialWriter::signedVarint(const int64_t& value) {
+    varint((uint64_t(value) << 1) ^ uint64_t(value >> 63));
+}
+
+void SerialWriter::bytes(const std::string_view& text) {
+    varint(text.size());
+    this->text(text);
+}
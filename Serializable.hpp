@@ -0,0 +1,70 @@
+#ifndef SERIALIZABLE_HPP
+#define SERIALIZABLE_HPP
+
+#include "Money.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @class SerialWriter
+ * @brief Appends encoded values to a caller-supplied string used as a growable byte buffer.
+ *
+ * Numbers are formatted with std::to_chars, with no locale or stream state.
+ * The binary encoding writes unsigned integers as LEB128 varints, signed
+ * integers zigzag-encoded as varints, money as signed cents and strings as a
+ * varint byte length followed by the bytes.
+ */
+class SerialWriter {
+public:
+    /**
+     * @param buffer The buffer to append to. It must outlive the writer.
+     */
+    explicit SerialWriter(std::string& buffer);
+
+    // Text output
+    void text(const std::string_view& text);
+    void character(const char& c);
+    void integer(const long long& value);
+    void decimal(const double& value);
+    void money(const Money& value);
+    void boolean(const bool& value);
+
+    /**
+     * Appends a quoted JSON string, escaping quotes, backslashes and control characters.
+     */
+    void jsonString(const std::string_view& text);
+
+    // Binary output
+    void byte(const uint8_t& value);
+    void varint(uint64_t value);
+    void signedVarint(const int64_t& value);
+    void bytes(const std::string_view& text);
+
+private:
+    std::string& buffer_;
+};
+
+/**
+ * @class Serializable
+ * @brief Interface for objects that can be exported as JSON, CSV or compact binary.
+ */
+class Serializable {
+public:
+    /**
+     * @enum Format
+     * @brief The supported encodings.
+     */
+    enum Format { JSON, CSV, BINARY };
+
+    virtual ~Serializable() = default;
+
+    /**
+     * Appends the object's encoding to a buffer.
+     * @param format The encoding to use.
+     * @param buffer The buffer to append to; existing contents are kept.
+     */
+    virtual void serialize(const Format& format, std::string& buffer) const = 0;
+};
+
+#endif // SERIALIZABLE_HPP
@@ -0,0 +1,246 @@
+/**
+ * Microbenchmarks of the kitchen hot paths, built by `make bench`.
+ *
+ * Each benchmark prints one JSON object per line:
+ * {"name":...,"iterations":...,"ns_per_op":...,"allocs_per_op":...,"ops_per_sec":...}
+ * Allocations are counted by replacing the global operator new.
+ * Pass a substring as the first argument to run only the matching benchmarks.
+ */
+
+#include "Appetizer.hpp"
+#include "ArrayBag.hpp"
+#include "Dessert.hpp"
+#include "DishCsv.hpp"
+#include "Kitchen.hpp"
+#include "MainCourse.hpp"
+#include "MenuPipeline.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<unsigned long long> allocation_count(0);
+
+// Minimum measuring time per benchmark.
+const std::chrono::nanoseconds MIN_TIME = std::chrono::milliseconds(200);
+
+// Keeps the optimizer from discarding results.
+volatile long long sink;
+
+// A stream buffer that discards everything, so output cost is only formatting.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+NullBuffer null_buffer;
+
+/**
+ * Runs `body` in growing batches until MIN_TIME has passed and prints the result.
+ * @param ops_per_call The number of operations one call of `body` performs.
+ */
+void run(const std::string& filter, const std::string& name, const int& ops_per_call, const std::function<void()>& body) {
+    if (name.find(filter) == std::string::npos) {
+        return;
+    }
+    body(); // warm up caches and lazily built state
+    long long calls = 1;
+    while (true) {
+        unsigned long long allocations_before = allocation_count.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < calls; i++) {
+            body();
+        }
+        std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+        unsigned long long allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+        if (elapsed >= MIN_TIME) {
+            double ops = double(calls) * ops_per_call;
+            double ns_per_op = double(elapsed.count()) / ops;
+            std::printf("{\"name\":\"%s\",\"iterations\":%.0f,\"ns_per_op\":%.2f,\"allocs_per_op\":%.3f,\"ops_per_sec\":%.0f}\n",
+                name.c_str(), ops, ns_per_op, double(allocations) / ops, 1e9 / ns_per_op);
+            std::fflush(stdout);
+            return;
+        }
+        calls *= 2;
+    }
+}
+
+/**
+ * @return All dishes of the CSV file, newly allocated; the caller deletes them.
+ */
+std::vector<Dish*> loadDishes(const std::string& filename) {
+    std::vector<Dish*> dishes;
+    std::ifstream file(filename);
+    std::string row;
+    std::getline(file, row); // skip the header
+    while (std::getline(file, row)) {
+        Dish* dish = DishCsv::parseRow(row);
+        if (dish != nullptr) {
+            dishes.push_back(dish);
+        }
+    }
+    return dishes;
+}
+
+/**
+ * Serves the given dishes, leaving the kitchen as it was before `fill()`.
+ */
+void empty(Kitchen& kitchen, const std::vector<Dish*>& dishes) {
+    for (Dish* dish : dishes) {
+        kitchen.serveDish(dish);
+    }
+}
+
+void fill(Kitchen& kitchen, const std::vector<Dish*>& dishes) {
+    for (Dish* dish : dishes) {
+        kitchen.newOrder(dish);
+    }
+}
+
+void benchArrayBag(const std::string& filter) {
+    for (int size : { 10, 50, 100 }) {
+        std::string suffix = "/" + std::to_string(size);
+        ArrayBag<int> bag;
+        for (int i = 0; i < size; i++) {
+            bag.add(i);
+        }
+        run(filter, "ArrayBag::add+remove" + suffix, 1, [&bag, size]() {
+            bag.remove(size - 1);
+            bag.add(size - 1);
+        });
+        run(filter, "ArrayBag::contains" + suffix, size, [&bag, size]() {
+            long long found = 0;
+            for (int i = 0; i < size; i++) {
+                found += bag.contains(i);
+            }
+            sink = found;
+        });
+        run(filter, "ArrayBag::getFrequencyOf" + suffix, size, [&bag, size]() {
+            long long found = 0;
+            for (int i = 0; i < size; i++) {
+                found += bag.getFrequencyOf(i);
+            }
+            sink = found;
+        });
+    }
+}
+
+void benchKitchen(const std::string& filter, const std::vector<Dish*>& dishes) {
+    int count = int(dishes.size());
+    Kitchen kitchen;
+    run(filter, "Kitchen::newOrder+serveDish", count, [&]() {
+        fill(kitchen, dishes);
+        empty(kitchen, dishes);
+    });
+    run(filter, "Kitchen::newOrders(tables of 10)+serveDish", count, [&]() {
+        for (int first = 0; first < count; first += 10) {
+            kitchen.newOrders(dishes.data() + first, std::min(10, count - first));
+        }
+        empty(kitchen, dishes);
+    });
+    // the release operations empty the kitchen, so each call refills it first
+    run(filter, "Kitchen::releaseDishesBelowPrepTime(fill+release)", count, [&]() {
+        fill(kitchen, dishes);
+        sink = kitchen.releaseDishesBelowPrepTime(30);
+        empty(kitchen, dishes);
+    });
+    run(filter, "Kitchen::releaseDishesOfCuisineType(fill+release)", count, [&]() {
+        fill(kitchen, dishes);
+        sink = kitchen.releaseDishesOfCuisineType("ITALIAN");
+        empty(kitchen, dishes);
+    });
+
+    fill(kitchen, dishes);
+    std::streambuf* cout_buffer = std::cout.rdbuf(&null_buffer);
+    run(filter, "Kitchen::kitchenReport", 1, [&]() {
+        kitchen.kitchenReport();
+    });
+    run(filter, "Dish::display(cached)", count, [&]() {
+        kitchen.displayMenu();
+    });
+    std::cout.rdbuf(cout_buffer);
+    empty(kitchen, dishes);
+
+    run(filter, "Kitchen::Kitchen(Dishes.csv)", 1, []() {
+        Kitchen loaded("Dishes.csv");
+        sink = loaded.getCurrentSize();
+    });
+    run(filter, "MenuPipeline::run(Dishes.csv)", 1, []() {
+        Kitchen loaded;
+        MenuPipeline::Options options;
+        options.output = nullptr;
+        MenuPipeline pipeline(loaded, options);
+        pipeline.run("Dishes.csv");
+        sink = loaded.getCurrentSize();
+    });
+}
+
+void benchDietary(const std::string& filter) {
+    // each call starts from a fresh copy, since the accommodations change the dish
+    Dish::DietaryRequest request = { true, true, true, true, true, true };
+    const Appetizer appetizer("Meat Skewers", { "Chicken", "Beef", "Flour", "Garlic", "Lamb", "Bread" }, 20, 8.99,
+        Dish::MEXICAN, Appetizer::PLATED, 5, false);
+    const MainCourse main_course("Lasagna", { "Pasta", "Beef", "Cheese", "Milk", "Tomato", "Basil" }, 60, 15.99,
+        Dish::ITALIAN, MainCourse::BAKED, "Beef", { { "Garlic Bread", MainCourse::BREAD }, { "Salad", MainCourse::SALAD } }, false);
+    const Dessert dessert("Nut Cake", { "Almonds", "Flour", "Eggs", "Butter", "Sugar", "Walnuts" }, 45, 6.49,
+        Dish::FRENCH, Dessert::SWEET, 8, true);
+    run(filter, "Appetizer::dietaryAccommodations(copy+adjust)", 1, [&]() {
+        Appetizer copy(appetizer);
+        copy.dietaryAccommodations(request);
+        sink = copy.ingredientCount();
+    });
+    run(filter, "MainCourse::dietaryAccommodations(copy+adjust)", 1, [&]() {
+        MainCourse copy(main_course);
+        copy.dietaryAccommodations(request);
+        sink = copy.ingredientCount();
+    });
+    run(filter, "Dessert::dietaryAccommodations(copy+adjust)", 1, [&]() {
+        Dessert copy(dessert);
+        copy.dietaryAccommodations(request);
+        sink = copy.ingredientCount();
+    });
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter = argc > 1 ? argv[1] : "";
+    std::vector<Dish*> dishes = loadDishes("Dishes.csv");
+    if (dishes.empty()) {
+        std::fprintf(stderr, "Could not load Dishes.csv\n");
+        return 1;
+    }
+    benchArrayBag(filter);
+    benchKitchen(filter, dishes);
+    benchDietary(filter);
+    for (Dish* dish : dishes) {
+        delete dish;
+    }
+    return 0;
+}
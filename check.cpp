@@ -0,0 +1,306 @@
+/**
+ * Regression checks of kitchen reporting, built and run by `make check`.
+ *
+ * Prints one line per failed check and exits with status 1 if any failed.
+ */
+
+#include "Appetizer.hpp"
+#include "DishCsv.hpp"
+#include "Histogram.hpp"
+#include "Kitchen.hpp"
+#include "MenuArchive.hpp"
+#include "MenuDiff.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+
+namespace {
+
+int failures = 0;
+
+void expect(const bool& condition, const std::string& what) {
+    if (!condition) {
+        std::printf("FAILED: %s\n", what.c_str());
+        failures++;
+    }
+}
+
+std::string report(const Kitchen& kitchen) {
+    std::ostringstream output;
+    std::streambuf* cout_buffer = std::cout.rdbuf(output.rdbuf());
+    kitchen.kitchenReport();
+    std::cout.rdbuf(cout_buffer);
+    return output.str();
+}
+
+// A kitchen holding one $7.50 dish reports $7.50 everywhere, not a bucket bound.
+void checkSingleDishPrice() {
+    Appetizer bruschetta("Bruschetta", { "Tomato", "Basil" }, 15, Money::fromCents(750), Dish::ITALIAN,
+        Appetizer::PLATED, 2, true);
+    Kitchen kitchen;
+    kitchen.newOrder(&bruschetta);
+    expect(report(kitchen).find("PRICE (MIN/P50/P90/P99/MAX): $7.50 / $7.50 / $7.50 / $7.50 / $7.50\n")
+            != std::string::npos, "one $7.50 dish reports $7.50 in kitchenReport()");
+    std::string json;
+    kitchen.serialize(Serializable::JSON, json);
+    expect(json.find("\"price\":{\"min\":7.50,\"p50\":7.50,\"p90\":7.50,\"p99\":7.50,\"max\":7.50}") != std::string::npos,
+        "one $7.50 dish reports $7.50 in the JSON export");
+}
+
+// The report's minimum and maximum prices are those of the menu.
+void checkMenuPriceRange() {
+    Kitchen kitchen("Dishes.csv");
+    std::vector<Dish*> by_price = kitchen.topK(Kitchen::PRICE, kitchen.getCurrentSize());
+    if (by_price.empty()) {
+        expect(false, "Dishes.csv loads");
+        return;
+    }
+    Money highest = by_price.front()->getPrice();
+    Money lowest = by_price.back()->getPrice();
+    std::ostringstream expected;
+    expected << "PRICE (MIN/P50/P90/P99/MAX): $" << lowest;
+    std::string text = report(kitchen);
+    expect(text.find(expected.str()) != std::string::npos, "Dishes.csv reports its lowest price as MIN");
+    std::ostringstream expected_max;
+    expected_max << " / $" << highest << "\n";
+    expect(text.find(expected_max.str()) != std::string::npos, "Dishes.csv reports its highest price as MAX");
+    expect(text.find("MEMORY") == std::string::npos, "kitchenReport() leaves out allocator-dependent memory figures");
+}
+
+// Histogram extremes are exact and its percentiles are recorded values.
+void checkHistogramValues() {
+    const long long values[] = { 948, 999, 1049, 3999, 3999, 9949 };
+    std::set<long long> recorded(std::begin(values), std::end(values));
+    Histogram first;
+    Histogram second;
+    for (int i = 0; i < 6; i++) {
+        (i % 2 == 0 ? first : second).add(values[i]);
+    }
+    first.merge(second);
+    expect(first.getMin() == 948, "Histogram::getMin() is the smallest value");
+    expect(first.getMax() == 9949, "Histogram::getMax() is the largest value");
+    for (double percentile : { 1.0, 25.0, 50.0, 75.0, 90.0, 99.0 }) {
+        expect(recorded.count(first.getPercentile(percentile)) == 1,
+            "Histogram::getPercentile(" + std::to_string(percentile) + ") is a recorded value");
+    }
+}
+
+// Serving a dish whose price and prep time changed in place leaves the
+// distributions of the remaining dishes intact.
+void checkServeChangedDish() {
+    Appetizer bruschetta("Bruschetta", { "Tomato", "Basil" }, 15, Money::fromCents(750), Dish::ITALIAN,
+        Appetizer::PLATED, 2, true);
+    Appetizer nachos("Nachos", { "Corn", "Cheese" }, 20, Money::fromCents(900), Dish::MEXICAN,
+        Appetizer::BUFFET, 3, true);
+    Kitchen kitchen;
+    kitchen.newOrder(&bruschetta);
+    kitchen.newOrder(&nachos);
+    bruschetta.setPrice(Money::fromCents(1250));
+    bruschetta.setPrepTime(5);
+    std::string text = report(kitchen);
+    expect(text.find("PRICE (MIN/P50/P90/P99/MAX): $9.00 / $9.00 / $12.50 / $12.50 / $12.50\n") != std::string::npos,
+        "the price distribution shows a price changed in place");
+    kitchen.serveDish(&bruschetta);
+    text = report(kitchen);
+    expect(text.find("PREP TIME (MIN/P50/P90/P99/MAX): 20 / 20 / 20 / 20 / 20\n") != std::string::npos,
+        "serving a dish changed in place leaves the other prep times");
+    expect(text.find("PRICE (MIN/P50/P90/P99/MAX): $9.00 / $9.00 / $9.00 / $9.00 / $9.00\n") != std::string::npos,
+        "serving a dish changed in place leaves the other prices");
+}
+
+// The totals follow setPrice(), setCuisineType() and setPrepTime() on a held dish.
+void checkChangeInPlace() {
+    Appetizer bruschetta("Bruschetta", { "Tomato", "Basil", "Bread", "Garlic", "Oil" }, 15, Money::fromCents(750),
+        Dish::ITALIAN, Appetizer::PLATED, 2, true);
+    Appetizer nachos("Nachos", { "Corn", "Cheese" }, 20, Money::fromCents(900), Dish::MEXICAN,
+        Appetizer::BUFFET, 3, true);
+    Kitchen kitchen;
+    kitchen.newOrder(&bruschetta);
+    kitchen.newOrder(&nachos);
+    uint64_t version = kitchen.version();
+    bruschetta.setPrice(Money::fromCents(1250));
+    bruschetta.setCuisineType(Dish::FRENCH);
+    bruschetta.setPrepTime(90);
+    expect(kitchen.totalRevenue() == Money::fromCents(2150), "totalRevenue() follows setPrice()");
+    expect(kitchen.averagePrice() == Money::fromCents(1075), "averagePrice() follows setPrice()");
+    expect(kitchen.cuisineRevenue("ITALIAN") == Money(), "cuisineRevenue() drops the old cuisine");
+    expect(kitchen.cuisineRevenue("FRENCH") == Money::fromCents(1250), "cuisineRevenue() follows setCuisineType()");
+    expect(kitchen.getPrepTimeSum() == 110, "getPrepTimeSum() follows setPrepTime()");
+    expect(kitchen.elaborateDishCount() == 1, "elaborateDishCount() follows setPrepTime()");
+    std::vector<KitchenEvent> events;
+    kitchen.eventsSince(version, events);
+    expect(kitchen.version() > version && events.size() == 1 && events[0].kind == KitchenEvent::DISH_CHANGED,
+        "a change in place is logged once as DISH_CHANGED");
+
+    kitchen.serveDish(&bruschetta);
+    expect(kitchen.totalRevenue() == Money::fromCents(900), "serving a changed dish takes back its new price");
+    expect(kitchen.cuisineRevenue("FRENCH") == Money(), "serving a changed dish takes back its new cuisine");
+    expect(kitchen.getPrepTimeSum() == 20 && kitchen.elaborateDishCount() == 0,
+        "serving a changed dish takes back its new prep time");
+}
+
+// A cached top-k ranking follows prices changed in place, up and down.
+void checkTopKAfterChange() {
+    Appetizer bruschetta("Bruschetta", { "Tomato" }, 15, Money::fromCents(750), Dish::ITALIAN,
+        Appetizer::PLATED, 2, true);
+    Appetizer nachos("Nachos", { "Corn" }, 20, Money::fromCents(900), Dish::MEXICAN,
+        Appetizer::BUFFET, 3, true);
+    Appetizer samosa("Samosa", { "Potato" }, 25, Money::fromCents(600), Dish::INDIAN,
+        Appetizer::PLATED, 4, true);
+    Kitchen kitchen;
+    kitchen.newOrder(&bruschetta);
+    kitchen.newOrder(&nachos);
+    kitchen.newOrder(&samosa);
+    expect(kitchen.topK(Kitchen::PRICE, 1) == std::vector<Dish*>{ &nachos }, "topK() ranks by price");
+    samosa.setPrice(Money::fromCents(1500));
+    expect(kitchen.topK(Kitchen::PRICE, 1) == std::vector<Dish*>{ &samosa }, "topK() follows a raised price");
+    samosa.setPrice(Money::fromCents(500));
+    expect(kitchen.topK(Kitchen::PRICE, 2) == std::vector<Dish*>({ &nachos, &bruschetta }),
+        "topK() follows a lowered price");
+    bruschetta.setPrepTime(40);
+    expect(kitchen.topK(Kitchen::PREP_TIME, 1) == std::vector<Dish*>{ &bruschetta }, "topK() follows setPrepTime()");
+}
+
+// A class defined by a rule file can be requested through DietaryRequest::avoid.
+void checkRuleDefinedClass() {
+    const char* rules_file = "check_rules.tmp";
+    {
+        std::ifstream defaults("DietaryRules.csv");
+        std::ofstream rules(rules_file);
+        rules << defaults.rdbuf() << "CONTAINS,SHELLFISH,Shrimp\n";
+    }
+    bool loaded = IngredientTable::instance().loadRules(rules_file);
+    std::remove(rules_file);
+    expect(loaded, "a rule file may define a new allergen class");
+    Dish::DietaryRequest request = {};
+    request.avoid = IngredientTable::instance().allergenClass("SHELLFISH");
+    expect(request.avoid != 0, "allergenClass() names a class defined by a rule file");
+
+    Appetizer skewers("Skewers", { "Shrimp", "Garlic" }, 10, Money::fromCents(800), Dish::OTHER,
+        Appetizer::PLATED, 1, true);
+    Kitchen kitchen;
+    kitchen.newOrder(&skewers);
+    expect(!skewers.isCompatible(request), "a dish with a class in avoid is not compatible");
+    expect(kitchen.filterDishes(request, false).empty(), "filterDishes() excludes a class in avoid");
+    expect(kitchen.filterDishes(request, true).size() == 1, "filterDishes() finds a dish adjustable for avoid");
+    kitchen.dietaryAdjustment(request);
+    expect(skewers.getIngredients() == std::vector<std::string>{ "Garlic" }, "dietaryAdjustment() removes a class in avoid");
+    expect(skewers.isCompatible(request), "an adjusted dish is compatible with avoid");
+    expect(kitchen.filterDishes(request, false).size() == 1, "filterDishes() finds an adjusted dish");
+
+    IngredientTable::instance().loadRules("DietaryRules.csv");
+}
+
+// Dishes.csv packs and unpacks without losing rows or cuisine names
+// that Dish::CuisineType lacks.
+void checkArchiveRoundTrip() {
+    const char* archive_file = "check_archive.tmp";
+    std::ifstream menu("Dishes.csv");
+    std::string row;
+    std::getline(menu, row); // the header
+    std::vector<std::string> expected;
+    std::vector<std::string> cuisines;
+    {
+        MenuArchiveWriter writer(archive_file, 16);
+        while (std::getline(menu, row)) {
+            Dish* dish = DishCsv::parseRow(row);
+            if (dish == nullptr) {
+                continue;
+            }
+            cuisines.push_back(DishCsv::cuisineName(row));
+            std::string formatted;
+            DishCsv::formatRow(*dish, cuisines.back(), formatted);
+            expected.push_back(formatted);
+            writer.add(dish, cuisines.back());
+            delete dish;
+        }
+        expect(writer.close(), "Dishes.csv packs into an archive");
+    }
+    MenuArchiveReader reader;
+    std::vector<Dish*> dishes;
+    std::vector<std::string> cuisine_names;
+    bool read = reader.open(archive_file) && reader.readRows(0, UINT64_MAX, dishes, &cuisine_names);
+    std::remove(archive_file);
+    expect(read, "the Dishes.csv archive reads back");
+    expect(dishes.size() == expected.size() && cuisine_names == cuisines, "the archive keeps every row and cuisine name");
+    for (size_t i = 0; i < dishes.size() && i < expected.size(); i++) {
+        std::string unpacked;
+        DishCsv::formatRow(*dishes[i], cuisine_names[i], unpacked);
+        expect(unpacked == expected[i], "row " + std::to_string(i + 1) + " of Dishes.csv unpacks as it was packed");
+        delete dishes[i];
+    }
+    expect(std::count(cuisines.begin(), cuisines.end(), "JAPANESE") == 5, "Dishes.csv has JAPANESE dishes to round-trip");
+}
+
+// An appetizer that counts its destructions.
+class CountedAppetizer : public Appetizer {
+public:
+    explicit CountedAppetizer(const std::string& name)
+        : Appetizer(name, { "Tomato" }, 10, Money::fromCents(500), Dish::ITALIAN, Appetizer::PLATED, 1, true) {
+    }
+    ~CountedAppetizer() override {
+        destroyed++;
+    }
+    static int destroyed;
+};
+
+int CountedAppetizer::destroyed = 0;
+
+// The kitchen deletes only the dishes it adopted, and never on serveDish().
+void checkOwnership() {
+    CountedAppetizer::destroyed = 0;
+    CountedAppetizer caller_owned("Caprese");
+    {
+        Kitchen kitchen;
+        kitchen.newOrder(&caller_owned);
+        kitchen.serveDish(&caller_owned);
+        expect(caller_owned.getName() == "Caprese", "a served dish is still the caller's");
+        kitchen.newOrder(&caller_owned);
+        kitchen.releaseDishesBelowPrepTime(60);
+        expect(caller_owned.getPrepTime() == 10, "a released dish is still the caller's");
+        kitchen.newOrder(&caller_owned);
+
+        CountedAppetizer* adopted = new CountedAppetizer("Bruschetta");
+        kitchen.newOrder(adopted);
+        kitchen.adoptDish(adopted);
+        kitchen.serveDish(adopted);
+        expect(CountedAppetizer::destroyed == 0, "serveDish() does not delete an adopted dish");
+
+        CountedAppetizer* removed = new CountedAppetizer("Crostini");
+        kitchen.newOrder(removed);
+        kitchen.adoptDish(removed);
+        MenuEdit edit;
+        edit.kind = MenuEdit::REMOVE;
+        removed->serialize(Serializable::CSV, edit.before);
+        while (!edit.before.empty() && edit.before.back() == '\n') {
+            edit.before.pop_back();
+        }
+        expect(kitchen.applyMenuDiff({ edit }) == 1, "applyMenuDiff() removes a held dish");
+        expect(CountedAppetizer::destroyed == 1, "applyMenuDiff() deletes an adopted dish it removes");
+    }
+    expect(CountedAppetizer::destroyed == 2, "the kitchen deletes a served adopted dish when destroyed");
+    expect(caller_owned.getName() == "Caprese", "the kitchen does not delete a held caller's dish");
+}
+
+} // namespace
+
+int main() {
+    checkSingleDishPrice();
+    checkMenuPriceRange();
+    checkHistogramValues();
+    checkServeChangedDish();
+    checkChangeInPlace();
+    checkTopKAfterChange();
+    checkRuleDefinedClass();
+    checkArchiveRoundTrip();
+    checkOwnership();
+    if (failures != 0) {
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}
@@ -8,9 +8,14 @@
 #include "MainCourse.hpp"
 #include "Dessert.hpp"
 #include "Appetizer.hpp"
+#include "IngredientTable.hpp"
 
 int main() {
 
+    if (!IngredientTable::instance().loadRules("DietaryRules.csv")) {
+        std::cerr << "Could not load DietaryRules.csv, using the built-in dietary rules" << std::endl;
+    }
+
     Appetizer myAppetizer("Bruschetta",  {"Tomato", "Basil", "Olive Oil"}, 15, 7.50, Dish::ITALIAN, Appetizer::PLATED, 2, true);
 
     myAppetizer.display();
@@ -0,0 +1,128 @@
+/**
+ * Packs menus and order history in the Dishes.csv format into columnar
+ * archives and reads them back, see MenuArchive.hpp.
+ *
+ * Usage:
+ *   menuarchive pack <menu.csv> <archive> [block_rows]
+ *   menuarchive unpack <archive> [first] [count]
+ *   menuarchive load <archive> [first]
+ *   menuarchive memory <archive> [first]
+ *
+ * `pack` reports the size of the archive against the CSV it came from.
+ * `unpack` writes rows of the archive to standard output as Dishes.csv,
+ * inflating only the blocks that hold them. `load` streams the archive
+ * into a Kitchen from row `first` on and prints its report. `memory` loads
+ * the same way and prints `Kitchen::memoryUsage()` by category; the figures
+ * depend on the allocator, which is why the report leaves them out.
+ */
+
+#include "DishCsv.hpp"
+#include "Kitchen.hpp"
+#include "MenuArchive.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+int pack(const std::string& menu_file, const std::string& archive_file, const size_t& block_rows) {
+    std::ifstream menu(menu_file, std::ios::binary);
+    std::string row;
+    if (!std::getline(menu, row)) {
+        std::fprintf(stderr, "menuarchive: could not read %s\n", menu_file.c_str());
+        return 1;
+    }
+    uint64_t csv_bytes = row.size() + 1;
+    uint64_t skipped = 0;
+    MenuArchiveWriter writer(archive_file, block_rows);
+    while (writer.isOpen() && std::getline(menu, row)) {
+        csv_bytes += row.size() + 1;
+        Dish* dish = DishCsv::parseRow(row);
+        if (dish == nullptr) {
+            skipped++;
+            continue;
+        }
+        writer.add(dish, DishCsv::cuisineName(row));
+        delete dish;
+    }
+    if (!writer.close()) {
+        std::fprintf(stderr, "menuarchive: could not write %s\n", archive_file.c_str());
+        return 1;
+    }
+    std::printf("rows: %llu (%llu malformed skipped)  csv: %llu bytes  archive: %llu bytes (%.1f%%)\n",
+        (unsigned long long)writer.rowCount(), (unsigned long long)skipped, (unsigned long long)csv_bytes,
+        (unsigned long long)writer.fileSize(), 100.0 * double(writer.fileSize()) / double(csv_bytes));
+    return 0;
+}
+
+int unpack(MenuArchiveReader& reader, const uint64_t& first, const uint64_t& count) {
+    std::vector<Dish*> dishes;
+    std::vector<std::string> cuisine_names;
+    bool ok = reader.readRows(first, count, dishes, &cuisine_names);
+    std::string buffer = "DishType,Name,Ingredients,PreparationTime,Price,CuisineType,AdditionalAttributes\n";
+    for (size_t i = 0; i < dishes.size(); i++) {
+        DishCsv::formatRow(*dishes[i], cuisine_names[i], buffer);
+        delete dishes[i];
+    }
+    std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+    if (!ok) {
+        std::fprintf(stderr, "menuarchive: corrupt block\n");
+        return 1;
+    }
+    return 0;
+}
+
+void printMemory(const Kitchen& kitchen) {
+    MemoryUsage usage = kitchen.memoryUsage();
+    const std::pair<const char*, size_t> categories[] = {
+        { "kitchen", usage.kitchen }, { "dish objects", usage.dish_objects }, { "names", usage.names },
+        { "ingredients", usage.ingredients }, { "side dishes", usage.side_dishes }, { "caches", usage.caches },
+        { "indexes", usage.indexes }, { "total", usage.total() },
+    };
+    for (const auto& category : categories) {
+        std::printf("%-13s %zu bytes\n", category.first, category.second);
+    }
+    size_t per_dish = kitchen.isEmpty() ? 0 : usage.dishBytes() / kitchen.getCurrentSize();
+    std::printf("%-13s %zu bytes\n", "per dish", per_dish);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string command = argc > 1 ? argv[1] : "";
+    if (command == "pack" && (argc == 4 || argc == 5)) {
+        return pack(argv[2], argv[3], argc == 5 ? std::strtoull(argv[4], nullptr, 10) : MenuArchiveWriter::DEFAULT_BLOCK_ROWS);
+    }
+    if ((command == "unpack" && argc >= 3 && argc <= 5) || ((command == "load" || command == "memory") && (argc == 3 || argc == 4))) {
+        MenuArchiveReader reader;
+        if (!reader.open(argv[2])) {
+            std::fprintf(stderr, "menuarchive: %s is not a readable archive\n", argv[2]);
+            return 1;
+        }
+        uint64_t first = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 0;
+        if (command == "unpack") {
+            return unpack(reader, first, argc > 4 ? std::strtoull(argv[4], nullptr, 10) : UINT64_MAX);
+        }
+        Kitchen kitchen;
+        if (reader.loadInto(kitchen, first) < 0) {
+            std::fprintf(stderr, "menuarchive: corrupt block\n");
+            return 1;
+        }
+        if (command == "memory") {
+            printMemory(kitchen);
+        } else {
+            kitchen.kitchenReport();
+        }
+        return 0;
+    }
+    std::fprintf(stderr, "usage: menuarchive pack <menu.csv> <archive> [block_rows]\n"
+                         "       menuarchive unpack <archive> [first] [count]\n"
+                         "       menuarchive load <archive> [first]\n"
+                         "       menuarchive memory <archive> [first]\n");
+    return 2;
+}
@@ -0,0 +1,88 @@
+/**
+ * Diff of two menus in the Dishes.csv format.
+ *
+ * Usage: menudiff <before.csv> <after.csv> [--apply]
+ *
+ * Prints the edit script from the old menu to the new one (see
+ * MenuEdit::format()) and a summary on standard error. With --apply, it
+ * also loads a kitchen from the old menu, applies the script with
+ * `Kitchen::applyMenuDiff()`, and compares the time and the resulting
+ * dishes with loading a kitchen from the new menu.
+ */
+
+#include "Kitchen.hpp"
+#include "MenuDiff.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double microseconds(const Clock::time_point& start, const Clock::time_point& end) {
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+/**
+ * @return The kitchen's dishes as Dishes.csv rows, sorted, so kitchens
+ * holding the same dishes in a different order compare equal.
+ */
+std::vector<std::string> sortedRows(const Kitchen& kitchen) {
+    std::string buffer;
+    kitchen.serialize(Serializable::CSV, buffer);
+    std::vector<std::string> rows;
+    size_t start = buffer.find('\n') + 1; // skip the header
+    while (start < buffer.size()) {
+        size_t end = buffer.find('\n', start);
+        rows.push_back(buffer.substr(start, end - start));
+        start = end + 1;
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool apply = argc == 4 && std::strcmp(argv[3], "--apply") == 0;
+    if (argc != 3 && !apply) {
+        std::fprintf(stderr, "usage: menudiff <before.csv> <after.csv> [--apply]\n");
+        return 2;
+    }
+    Clock::time_point start = Clock::now();
+    std::vector<MenuEdit> edits;
+    if (!MenuDiff::diffFiles(argv[1], argv[2], edits)) {
+        std::fprintf(stderr, "menudiff: could not read %s or %s\n", argv[1], argv[2]);
+        return 1;
+    }
+    double diff_us = microseconds(start, Clock::now());
+
+    int counts[3] = {};
+    std::string script;
+    for (const MenuEdit& edit : edits) {
+        counts[edit.kind]++;
+        edit.format(script);
+    }
+    std::fwrite(script.data(), 1, script.size(), stdout);
+    std::fprintf(stderr, "%d added, %d removed, %d changed; diff: %.0f us\n", counts[MenuEdit::ADD],
+        counts[MenuEdit::REMOVE], counts[MenuEdit::CHANGE], diff_us);
+    if (!apply) {
+        return 0;
+    }
+
+    Kitchen live(argv[1]);
+    start = Clock::now();
+    int applied = live.applyMenuDiff(edits);
+    double apply_us = microseconds(start, Clock::now());
+    start = Clock::now();
+    Kitchen reloaded(argv[2]);
+    double reload_us = microseconds(start, Clock::now());
+    bool match = sortedRows(live) == sortedRows(reloaded);
+    std::fprintf(stderr, "apply: %.0f us, %d of %zu edits; reload: %.0f us; same dishes as reload: %s\n", apply_us,
+        applied, edits.size(), reload_us, match ? "yes" : "no");
+    return match ? 0 : 1;
+}
@@ -0,0 +1,447 @@
+/**
+ * Deterministic generator of synthetic menus and order traces for scale testing.
+ *
+ * Usage:
+ *   menugen menu <rows> [seed]
+ *   menugen trace <menu.csv> <events> [seed] [events_per_second] [capacity]
+ *
+ * `menu` writes a Dishes.csv-format menu to standard output. Dish types,
+ * cuisines, ingredient counts, ingredients (Zipf-distributed over a fixed
+ * vocabulary that includes every allergen class), side dishes and dietary
+ * flags follow fixed distributions, so a seed always yields the same file.
+ *
+ * `trace` writes an order trace (see OrderTrace.hpp) for a menu file:
+ * orders and serves of menu rows interleaved with release, dietary and
+ * report events, arriving as a Poisson process at `events_per_second`.
+ * The generator replays the events on a model of a kitchen holding at most
+ * `capacity` dishes, using the rows' prep times and cuisines, so that the
+ * orders and serves succeed when the trace is replayed in order.
+ */
+
+#include "Appetizer.hpp"
+#include "Dessert.hpp"
+#include "DishCsv.hpp"
+#include "MainCourse.hpp"
+#include "OrderTrace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * SplitMix64: a small, fast generator whose output depends only on the seed.
+ */
+class SplitMix64 {
+public:
+    explicit SplitMix64(const uint64_t& seed) : state_(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, bound).
+    uint64_t below(const uint64_t& bound) {
+        return next() % bound;
+    }
+
+    // Uniform in [low, high].
+    int between(const int& low, const int& high) {
+        return low + int(below(uint64_t(high - low + 1)));
+    }
+
+    // Uniform in [0, 1).
+    double real() {
+        return double(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    bool chance(const double& probability) {
+        return real() < probability;
+    }
+
+private:
+    uint64_t state_;
+};
+
+/**
+ * Draws indices with probability proportional to fixed weights.
+ */
+class WeightedChoice {
+public:
+    explicit WeightedChoice(const std::vector<double>& weights) {
+        double total = 0;
+        for (double weight : weights) {
+            total += weight;
+            cumulative_.push_back(total);
+        }
+        for (double& value : cumulative_) {
+            value /= total;
+        }
+    }
+
+    /**
+     * @return Weights 1/rank^exponent for `count` ranks, a Zipf distribution.
+     */
+    static WeightedChoice zipf(const size_t& count, const double& exponent) {
+        std::vector<double> weights;
+        for (size_t rank = 1; rank <= count; rank++) {
+            weights.push_back(1.0 / std::pow(double(rank), exponent));
+        }
+        return WeightedChoice(weights);
+    }
+
+    size_t draw(SplitMix64& random) const {
+        return std::upper_bound(cumulative_.begin(), cumulative_.end(), random.real()) - cumulative_.begin();
+    }
+
+private:
+    std::vector<double> cumulative_;
+};
+
+// Savory ingredients, most common first. Every allergen class of the default rules appears.
+const std::vector<std::string> SAVORY = {
+    "Garlic", "Onion", "Olive Oil", "Tomato", "Salt", "Black Pepper", "Chicken", "Cheese", "Butter", "Flour",
+    "Basil", "Lemon", "Beef", "Rice", "Eggs", "Bell Peppers", "Carrots", "Cilantro", "Potatoes", "Parsley",
+    "Mushrooms", "Pork", "Cream", "Bread", "Shrimp", "Spinach", "Ginger", "Soy Sauce", "Pasta", "Cumin",
+    "Fish", "Lime", "Chili", "Avocado", "Beans", "Corn", "Bacon", "Yogurt", "Lamb", "Chickpeas",
+    "Zucchini", "Eggplant", "Peanuts", "Cashews", "Thyme", "Rosemary", "Paprika", "Milk", "Cabbage", "Noodles",
+    "Tofu", "Coconut Milk", "Lentils", "Oregano", "Walnuts", "Barley", "Celery", "Scallions", "Sesame", "Almonds",
+};
+
+// Sweet ingredients, most common first.
+const std::vector<std::string> SWEET = {
+    "Sugar", "Flour", "Butter", "Eggs", "Milk", "Cream", "Vanilla", "Chocolate", "Strawberries", "Lemon",
+    "Almonds", "Cinnamon", "Honey", "Walnuts", "Apples", "Yogurt", "Cocoa", "Pecans", "Hazelnuts", "Oats",
+    "Blueberries", "Caramel", "Bananas", "Coconut", "Raspberries", "Pistachios", "Mascarpone", "Crust", "Peaches", "Mint",
+    "Cherries", "Maple Syrup", "Ginger", "Orange", "Mango", "Gelatin", "Nutmeg", "Cashews", "Dates", "Rum",
+};
+
+// Variants multiply each vocabulary into a long tail of rarer ingredients.
+const std::vector<std::string> VARIANTS = { "", "Fresh ", "Roasted ", "Smoked ", "Wild ", "Aged ", "Pickled ", "Dried ", "Organic " };
+
+const std::vector<std::string> ADJECTIVES = {
+    "Classic", "Spicy", "Golden", "Rustic", "Crispy", "Smoky", "Tangy", "Creamy", "Herbed", "Glazed",
+    "Charred", "Zesty", "Savory", "Velvet", "Garden", "Country", "Royal", "Sunny", "Midnight", "Harvest",
+};
+
+const std::vector<std::string> APPETIZER_NOUNS = {
+    "Bruschetta", "Spring Rolls", "Dumplings", "Skewers", "Fritters", "Sliders", "Wings", "Nachos", "Crostini", "Samosas",
+};
+
+const std::vector<std::string> MAIN_NOUNS = {
+    "Curry", "Stew", "Risotto", "Stir Fry", "Burger", "Lasagna", "Tacos", "Roast", "Paella", "Casserole",
+};
+
+const std::vector<std::string> DESSERT_NOUNS = {
+    "Tart", "Cake", "Pudding", "Mousse", "Cheesecake", "Sorbet", "Crumble", "Brownie", "Parfait", "Pie",
+};
+
+const std::vector<std::string> PROTEINS = { "Chicken", "Beef", "Pork", "Fish", "Lamb", "Shrimp", "Tofu", "Beans" };
+
+const std::vector<std::string> SIDES = {
+    "Steamed Rice:GRAIN", "Garlic Bread:BREAD", "Side Salad:SALAD", "Mashed Potatoes:STARCHES", "French Fries:STARCHES",
+    "Green Beans:VEGETABLE", "Miso Soup:SOUP", "Black Beans:LEGUME", "Penne:PASTA", "Roasted Vegetables:VEGETABLE",
+    "Quinoa:GRAIN", "Dinner Roll:BREAD",
+};
+
+// Cuisine names as in Dishes.csv, with a few unknown ones that load as OTHER.
+const std::vector<std::string> CUISINES = {
+    "ITALIAN", "AMERICAN", "MEXICAN", "FRENCH", "INDIAN", "CHINESE", "OTHER", "JAPANESE", "MEDITERRANEAN", "THAI",
+};
+
+std::vector<std::string> expand(const std::vector<std::string>& vocabulary) {
+    std::vector<std::string> expanded;
+    for (const std::string& variant : VARIANTS) {
+        for (const std::string& ingredient : vocabulary) {
+            expanded.push_back(variant + ingredient);
+        }
+    }
+    return expanded;
+}
+
+// Appends `count` distinct ingredients drawn from `vocabulary`, separated by ';'.
+void appendIngredients(std::string& row, SplitMix64& random, const std::vector<std::string>& vocabulary,
+    const WeightedChoice& choice, const int& count, AllergenMask& allergens) {
+    std::vector<size_t> chosen;
+    while (int(chosen.size()) < count) {
+        size_t index = choice.draw(random);
+        if (std::find(chosen.begin(), chosen.end(), index) == chosen.end()) {
+            chosen.push_back(index);
+        }
+    }
+    IngredientTable& table = IngredientTable::instance();
+    for (int i = 0; i < count; i++) {
+        if (i != 0) {
+            row.push_back(';');
+        }
+        const std::string& ingredient = vocabulary[chosen[i]];
+        row.append(ingredient);
+        allergens |= table.allergensOf(table.intern(ingredient));
+    }
+}
+
+void appendPrice(std::string& row, const int& cents) {
+    row.append(std::to_string(cents / 100));
+    row.push_back('.');
+    row.push_back(char('0' + cents % 100 / 10));
+    row.push_back(char('0' + cents % 10));
+}
+
+// Ingredient counts cluster around 5, between 2 and 12.
+int ingredientCount(SplitMix64& random) {
+    return std::min(12, 2 + random.between(0, 3) + random.between(0, 3) + random.between(0, 4) / 2);
+}
+
+int generateMenu(const long long& rows, const uint64_t& seed) {
+    SplitMix64 random(seed);
+    std::vector<std::string> savory = expand(SAVORY);
+    std::vector<std::string> sweet = expand(SWEET);
+    WeightedChoice savory_choice = WeightedChoice::zipf(savory.size(), 1.1);
+    WeightedChoice sweet_choice = WeightedChoice::zipf(sweet.size(), 1.1);
+    WeightedChoice type_choice({ 35, 40, 25 });
+    WeightedChoice cuisine_choice({ 18, 17, 10, 11, 6, 5, 12, 8, 7, 6 });
+    WeightedChoice flavor_choice({ 70, 8, 12, 5, 5 });
+
+    std::string row;
+    std::string buffer = "DishType,Name,Ingredients,PreparationTime,Price,CuisineType,AdditionalAttributes\n";
+    for (long long r = 0; r < rows; r++) {
+        row.clear();
+        AllergenMask allergens = 0;
+        size_t type = type_choice.draw(random);
+        const std::vector<std::string>& nouns = type == 0 ? APPETIZER_NOUNS : type == 1 ? MAIN_NOUNS : DESSERT_NOUNS;
+        std::string name = ADJECTIVES[random.below(ADJECTIVES.size())] + " " + nouns[random.below(nouns.size())];
+        int prep_time = type == 0 ? random.between(1, 8) * 5 : type == 1 ? random.between(3, 24) * 5 : random.between(2, 16) * 5;
+        int cents = type == 0 ? random.between(399, 1299) : type == 1 ? random.between(899, 3999) : random.between(349, 1199);
+        cents = cents / 50 * 50 + 49; // prices end in .49 or .99
+
+        row.append(type == 0 ? "APPETIZER," : type == 1 ? "MAINCOURSE," : "DESSERT,");
+        row.append(name);
+        row.push_back(',');
+        if (type == 2) {
+            appendIngredients(row, random, sweet, sweet_choice, ingredientCount(random), allergens);
+        } else {
+            appendIngredients(row, random, savory, savory_choice, ingredientCount(random), allergens);
+        }
+        row.push_back(',');
+        row.append(std::to_string(prep_time));
+        row.push_back(',');
+        appendPrice(row, cents);
+        row.push_back(',');
+        row.append(CUISINES[cuisine_choice.draw(random)]);
+        row.push_back(',');
+
+        if (type == 0) {
+            row.append(Appetizer::SERVING_STYLE_NAMES[random.below(3)]);
+            row.push_back(';');
+            row.append(std::to_string(random.between(0, 5)));
+            row.append((allergens & IngredientTable::MEAT) == 0 ? ";true" : ";false");
+        } else if (type == 1) {
+            row.append(MainCourse::COOKING_METHOD_NAMES[random.below(6)]);
+            row.push_back(';');
+            row.append(PROTEINS[random.below(PROTEINS.size())]);
+            row.push_back(';');
+            int sides = random.between(0, 3);
+            bool gluten_side = false;
+            size_t first_side = random.below(SIDES.size());
+            for (int s = 0; s < sides; s++) {
+                const std::string& side = SIDES[(first_side + s * 5) % SIDES.size()]; // distinct, 5 and 12 are coprime
+                row.append(s == 0 ? "" : "|");
+                row.append(side);
+                gluten_side = gluten_side || side.find(":GRAIN") != std::string::npos || side.find(":PASTA") != std::string::npos
+                    || side.find(":BREAD") != std::string::npos || side.find(":STARCHES") != std::string::npos;
+            }
+            bool gluten_free = (allergens & IngredientTable::GLUTEN) == 0 && !gluten_side;
+            row.append(gluten_free ? ";true" : ";false");
+        } else {
+            row.append(Dessert::FLAVOR_PROFILE_NAMES[flavor_choice.draw(random)]);
+            row.push_back(';');
+            row.append(std::to_string(random.between(1, 10)));
+            row.append((allergens & IngredientTable::NUTS) != 0 ? ";true" : ";false");
+        }
+        row.push_back('\n');
+        buffer.append(row);
+        if (buffer.size() >= (1 << 20)) {
+            std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+            buffer.clear();
+        }
+    }
+    std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+    return 0;
+}
+
+/**
+ * What the trace generator needs to know about one menu row.
+ */
+struct MenuRow {
+    bool valid;         // false if the row does not parse, so orders of it would fail
+    int prep_time;
+    std::string cuisine;
+};
+
+bool loadMenu(const std::string& filename, std::vector<MenuRow>& menu) {
+    std::ifstream file(filename);
+    std::string row;
+    if (!std::getline(file, row)) {
+        return false;
+    }
+    while (std::getline(file, row)) {
+        Dish* dish = DishCsv::parseRow(row);
+        menu.push_back(dish == nullptr ? MenuRow{ false, 0, "" } : MenuRow{ true, dish->getPrepTime(), dish->getCuisineType() });
+        delete dish;
+    }
+    return true;
+}
+
+/**
+ * The rows in the kitchen, in no particular order, with O(1) insert and remove.
+ */
+class KitchenModel {
+public:
+    explicit KitchenModel(const size_t& rows) : position_(rows, -1) {}
+
+    size_t size() const { return rows_.size(); }
+    bool contains(const long long& row) const { return position_[row] >= 0; }
+    long long at(const size_t& index) const { return rows_[index]; }
+
+    void add(const long long& row) {
+        position_[row] = (long long)rows_.size();
+        rows_.push_back(row);
+    }
+
+    void remove(const long long row) { // by value: callers may pass an element of rows_
+        long long index = position_[row];
+        rows_[index] = rows_.back();
+        position_[rows_[index]] = index;
+        rows_.pop_back();
+        position_[row] = -1;
+    }
+
+    template <typename Predicate>
+    void removeIf(const Predicate& predicate) {
+        for (size_t i = rows_.size(); i-- > 0;) {
+            if (predicate(rows_[i])) {
+                remove(rows_[i]);
+            }
+        }
+    }
+
+private:
+    std::vector<long long> rows_;
+    std::vector<long long> position_; // index into rows_ by row, or -1
+};
+
+int generateTrace(const std::vector<MenuRow>& menu, const long long& events, const uint64_t& seed,
+    const double& events_per_second, const int& capacity) {
+    SplitMix64 random(seed);
+    WeightedChoice kind_choice({ 45, 40, 4, 4, 6, 1 });
+    KitchenModel kitchen(menu.size());
+    double time_us = 0;
+
+    std::string buffer = OrderEvent::HEADER;
+    buffer.push_back('\n');
+    OrderEvent event;
+    for (long long e = 0; e < events; e++) {
+        time_us += -std::log(1.0 - random.real()) * 1e6 / events_per_second;
+        event.time_us = int64_t(time_us);
+        size_t kind = kind_choice.draw(random);
+        if (kind == OrderEvent::ORDER && int(kitchen.size()) >= capacity) {
+            kind = OrderEvent::SERVE;
+        }
+        if (kind == OrderEvent::SERVE && kitchen.size() == 0) {
+            kind = OrderEvent::ORDER;
+        }
+        event.kind = OrderEvent::Kind(kind);
+        event.cuisine.clear();
+        switch (event.kind) {
+            case OrderEvent::ORDER: {
+                // the kitchen rejects a row it already holds, so draw again a few times
+                long long row = (long long)random.below(menu.size());
+                for (int attempt = 0; attempt < 8 && (kitchen.contains(row) || !menu[row].valid); attempt++) {
+                    row = (long long)random.below(menu.size());
+                }
+                if (!kitchen.contains(row) && menu[row].valid) {
+                    kitchen.add(row);
+                }
+                event.argument = row;
+                break;
+            }
+            case OrderEvent::SERVE: {
+                long long row = kitchen.at(random.below(kitchen.size()));
+                kitchen.remove(row);
+                event.argument = row;
+                break;
+            }
+            case OrderEvent::RELEASE_PREP: {
+                int prep_time = random.between(1, 6) * 5;
+                kitchen.removeIf([&](const long long& row) { return menu[row].prep_time < prep_time; });
+                event.argument = prep_time;
+                break;
+            }
+            case OrderEvent::RELEASE_CUISINE: {
+                event.cuisine = Dish::CUISINE_TYPE_NAMES[random.below(Dish::OTHER + 1)];
+                kitchen.removeIf([&](const long long& row) { return menu[row].cuisine == event.cuisine; });
+                break;
+            }
+            case OrderEvent::DIETARY:
+                event.argument = int64_t(1) << random.below(6);
+                if (random.chance(0.3)) {
+                    event.argument |= int64_t(1) << random.below(6);
+                }
+                break;
+            case OrderEvent::REPORT:
+                event.argument = 0;
+                break;
+        }
+        event.format(buffer);
+        if (buffer.size() >= (1 << 20)) {
+            std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+            buffer.clear();
+        }
+    }
+    std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+    return 0;
+}
+
+int usage() {
+    std::fprintf(stderr, "usage: menugen menu <rows> [seed]\n"
+        "       menugen trace <menu.csv> <events> [seed] [events_per_second] [capacity]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        return usage();
+    }
+    std::string mode = argv[1];
+    if (mode == "menu") {
+        long long rows = std::atoll(argv[2]);
+        uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1;
+        return rows > 0 ? generateMenu(rows, seed) : usage();
+    }
+    if (mode == "trace" && argc >= 4) {
+        std::vector<MenuRow> menu;
+        long long events = std::atoll(argv[3]);
+        uint64_t seed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+        double events_per_second = argc > 5 ? std::atof(argv[5]) : 10000;
+        int capacity = argc > 6 ? std::atoi(argv[6]) : 100;
+        if (events < 0 || events_per_second <= 0 || capacity <= 0) {
+            return usage();
+        }
+        if (!loadMenu(argv[2], menu) || menu.empty()) {
+            std::fprintf(stderr, "menugen: could not read a menu from %s\n", argv[2]);
+            return 1;
+        }
+        return generateTrace(menu, events, seed, events_per_second, capacity);
+    }
+    return usage();
+}
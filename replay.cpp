@@ -0,0 +1,246 @@
+/**
+ * Open-loop replay of an order trace against a Kitchen.
+ *
+ * Usage: replay <menu.csv> <trace.csv> [threads] [speed]
+ *
+ * The menu is loaded with DishCsv, and ORDER and SERVE events refer to its
+ * rows (see OrderTrace.hpp). Event i is issued by client thread i % threads
+ * at its trace time divided by `speed`, whether or not earlier calls have
+ * finished, and all clients share one Kitchen behind a mutex.
+ *
+ * Latency is measured from the time an event was scheduled, not from the
+ * time its thread got around to issuing it. A stalled kitchen therefore
+ * shows up in the percentiles of every call queued behind it instead of
+ * hiding as one slow sample (coordinated-omission correction). The service
+ * time, from issue to completion, is reported alongside for comparison.
+ */
+
+#include "DishCsv.hpp"
+#include "Histogram.hpp"
+#include "Kitchen.hpp"
+#include "OrderTrace.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const std::chrono::microseconds SPIN_TIME(200);
+
+const int KIND_COUNT = OrderEvent::REPORT + 1;
+const char* const KIND_LABELS[KIND_COUNT] = { "newOrder", "serveDish", "releaseDishesBelowPrepTime",
+    "releaseDishesOfCuisineType", "dietaryAdjustment", "kitchenReport" };
+
+// Discards kitchenReport() output, so only its computation is timed.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+/**
+ * Latencies in nanoseconds and call counts of one client, per event kind.
+ */
+struct ClientStats {
+    Histogram response[KIND_COUNT];
+    Histogram service[KIND_COUNT];
+    long long failed[KIND_COUNT] = {};
+};
+
+struct Replay {
+    std::vector<Dish*> menu;        // by row; nullptr if the row did not parse
+    std::vector<OrderEvent> events;
+    std::mutex kitchen_mutex;
+    Kitchen kitchen;
+    Clock::time_point start;
+    double speed = 1;
+};
+
+Dish::DietaryRequest requestFromFlags(const int64_t& flags) {
+    Dish::DietaryRequest request = {};
+    request.vegetarian = flags & 1;
+    request.vegan = flags & 2;
+    request.gluten_free = flags & 4;
+    request.nut_free = flags & 8;
+    request.low_sodium = flags & 16;
+    request.low_sugar = flags & 32;
+    return request;
+}
+
+/**
+ * Performs one event on the kitchen; the caller holds the kitchen mutex.
+ * @return False if the call failed or the event refers to an unknown row.
+ */
+bool perform(Replay& replay, const OrderEvent& event) {
+    Dish* dish = nullptr;
+    if (event.kind == OrderEvent::ORDER || event.kind == OrderEvent::SERVE) {
+        if (event.argument < 0 || event.argument >= (int64_t)replay.menu.size()) {
+            return false;
+        }
+        dish = replay.menu[event.argument];
+        if (dish == nullptr) {
+            return false;
+        }
+    }
+    switch (event.kind) {
+        case OrderEvent::ORDER:
+            return replay.kitchen.newOrder(dish);
+        case OrderEvent::SERVE:
+            return replay.kitchen.serveDish(dish);
+        case OrderEvent::RELEASE_PREP:
+            replay.kitchen.releaseDishesBelowPrepTime(int(event.argument));
+            return true;
+        case OrderEvent::RELEASE_CUISINE:
+            replay.kitchen.releaseDishesOfCuisineType(event.cuisine);
+            return true;
+        case OrderEvent::DIETARY:
+            replay.kitchen.dietaryAdjustment(requestFromFlags(event.argument));
+            return true;
+        case OrderEvent::REPORT:
+            replay.kitchen.kitchenReport();
+            return true;
+    }
+    return false;
+}
+
+void runClient(Replay& replay, const size_t& first, const size_t& stride, ClientStats& stats) {
+    for (size_t i = first; i < replay.events.size(); i += stride) {
+        const OrderEvent& event = replay.events[i];
+        Clock::time_point scheduled = replay.start
+            + std::chrono::nanoseconds((long long)(double(event.time_us) * 1000.0 / replay.speed));
+        // sleeping overshoots by tens of microseconds, so spin for the last stretch
+        if (Clock::now() < scheduled - SPIN_TIME) {
+            std::this_thread::sleep_until(scheduled - SPIN_TIME);
+        }
+        while (Clock::now() < scheduled) {
+        }
+        Clock::time_point issued = Clock::now();
+        bool ok;
+        {
+            std::lock_guard<std::mutex> lock(replay.kitchen_mutex);
+            ok = perform(replay, event);
+        }
+        Clock::time_point done = Clock::now();
+        stats.response[event.kind].add(std::chrono::duration_cast<std::chrono::nanoseconds>(done - scheduled).count());
+        stats.service[event.kind].add(std::chrono::duration_cast<std::chrono::nanoseconds>(done - issued).count());
+        if (!ok) {
+            stats.failed[event.kind]++;
+        }
+    }
+}
+
+bool loadMenu(const std::string& filename, std::vector<Dish*>& menu) {
+    std::ifstream file(filename);
+    std::string row;
+    if (!std::getline(file, row)) {
+        return false;
+    }
+    while (std::getline(file, row)) {
+        menu.push_back(DishCsv::parseRow(row));
+    }
+    return true;
+}
+
+bool loadTrace(const std::string& filename, std::vector<OrderEvent>& events) {
+    std::ifstream file(filename);
+    std::string line;
+    if (!std::getline(file, line)) {
+        return false;
+    }
+    OrderEvent event;
+    while (std::getline(file, line)) {
+        if (OrderEvent::parse(line, event)) {
+            events.push_back(event);
+        }
+    }
+    return true;
+}
+
+void printRow(const char* label, const char* measure, const Histogram& histogram, const double& seconds,
+    const long long& failed) {
+    std::printf("%-28s %-8s %10lld %8lld %12.0f %10.1f %10.1f %10.1f %10.1f\n", label, measure,
+        histogram.getCount(), failed, double(histogram.getCount()) / seconds,
+        histogram.getPercentile(50) / 1000.0, histogram.getPercentile(99) / 1000.0,
+        histogram.getPercentile(99.9) / 1000.0, histogram.getMax() / 1000.0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: replay <menu.csv> <trace.csv> [threads] [speed]\n");
+        return 2;
+    }
+    int threads = argc > 3 ? std::atoi(argv[3]) : 1;
+    Replay replay;
+    replay.speed = argc > 4 ? std::atof(argv[4]) : 1;
+    if (threads <= 0 || replay.speed <= 0) {
+        std::fprintf(stderr, "replay: threads and speed must be positive\n");
+        return 2;
+    }
+    if (!loadMenu(argv[1], replay.menu)) {
+        std::fprintf(stderr, "replay: could not read %s\n", argv[1]);
+        return 1;
+    }
+    if (!loadTrace(argv[2], replay.events)) {
+        std::fprintf(stderr, "replay: could not read %s\n", argv[2]);
+        return 1;
+    }
+
+    NullBuffer null_buffer;
+    std::streambuf* cout_buffer = std::cout.rdbuf(&null_buffer);
+    std::vector<ClientStats> stats(threads);
+    std::vector<std::thread> clients;
+    replay.start = Clock::now();
+    for (int t = 0; t < threads; t++) {
+        clients.emplace_back(runClient, std::ref(replay), size_t(t), size_t(threads), std::ref(stats[t]));
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - replay.start).count();
+    std::cout.rdbuf(cout_buffer);
+
+    ClientStats total;
+    for (const ClientStats& client : stats) {
+        for (int k = 0; k < KIND_COUNT; k++) {
+            total.response[k].merge(client.response[k]);
+            total.service[k].merge(client.service[k]);
+            total.failed[k] += client.failed[k];
+        }
+    }
+    double intended = replay.events.empty() ? 0 : replay.events.back().time_us / 1e6 / replay.speed;
+    std::printf("events: %zu  threads: %d  intended: %.3f s  elapsed: %.3f s  throughput: %.0f ops/s\n",
+        replay.events.size(), threads, intended, seconds, replay.events.size() / seconds);
+    std::printf("%-28s %-8s %10s %8s %12s %10s %10s %10s %10s\n", "operation", "latency", "count", "failed",
+        "ops/s", "p50_us", "p99_us", "p99.9_us", "max_us");
+    Histogram all_response;
+    Histogram all_service;
+    long long all_failed = 0;
+    for (int k = 0; k < KIND_COUNT; k++) {
+        all_response.merge(total.response[k]);
+        all_service.merge(total.service[k]);
+        all_failed += total.failed[k];
+        if (total.response[k].getCount() == 0) {
+            continue;
+        }
+        printRow(KIND_LABELS[k], "response", total.response[k], seconds, total.failed[k]);
+        printRow(KIND_LABELS[k], "service", total.service[k], seconds, total.failed[k]);
+    }
+    printRow("all", "response", all_response, seconds, all_failed);
+    printRow("all", "service", all_service, seconds, all_failed);
+
+    for (Dish* dish : replay.menu) {
+        delete dish;
+    }
+    return 0;
+}
@@ -0,0 +1,435 @@
+/**
+ * Order-intake server: one shared Kitchen behind a Unix domain socket.
+ *
+ * Usage: server <socket_path> <menu.csv> [threads]
+ *
+ * Dishes are ordered by their 0-based row in the menu file, as in order
+ * traces (see OrderTrace.hpp). Linux only: the event loops use epoll.
+ *
+ * Protocol. Every message in either direction is a frame: a 4-byte
+ * little-endian payload length followed by the payload. A request payload
+ * is an opcode byte and its arguments; varints are unsigned LEB128 as
+ * written by SerialWriter::varint().
+ *   1 ORDER            varint row
+ *   2 SERVE            varint row
+ *   3 RELEASE_PREP     varint minutes           -> varint released count
+ *   4 RELEASE_CUISINE  cuisine name (rest)      -> varint released count
+ *   5 DIETARY          byte flags (as in OrderTrace.hpp)
+ *   6 REPORT                                    -> kitchenReport() text
+ *   7 EXPORT           byte Serializable::Format -> Kitchen::serialize() output
+ * A response payload is a status byte (0 OK, 1 FAILED when the kitchen
+ * rejected the call, 2 BAD_REQUEST) followed by the result shown above, if
+ * OK. Clients may pipeline requests; responses come back in request order.
+ *
+ * Each event-loop thread reads every ready connection, collects the complete
+ * frames into a batch, and applies the whole batch to the kitchen under one
+ * lock acquisition before writing the responses. A connection buffers at
+ * most MAX_INPUT request bytes and gives at most MAX_FRAMES_PER_TICK frames
+ * to a batch; the rest waits for the next batch, so one busy client cannot
+ * starve the others. A connection is not read while more than MAX_OUTPUT
+ * response bytes wait for its client to read them.
+ */
+
+#include "DishCsv.hpp"
+#include "Kitchen.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+enum Opcode : uint8_t { ORDER = 1, SERVE, RELEASE_PREP, RELEASE_CUISINE, DIETARY, REPORT, EXPORT };
+enum Status : uint8_t { OK = 0, FAILED = 1, BAD_REQUEST = 2 };
+
+const size_t MAX_FRAME = 1 << 20;
+const size_t MAX_INPUT = 2 * MAX_FRAME;
+const size_t MAX_OUTPUT = 4 * MAX_FRAME;
+const int MAX_FRAMES_PER_TICK = 64;
+const int MAX_EVENTS = 64;
+const size_t READ_SIZE = 64 * 1024;
+
+std::atomic<bool> stopping(false);
+
+void requestStop(int) {
+    stopping.store(true);
+}
+
+struct Connection {
+    std::string input;
+    std::string output;
+    size_t output_sent = 0;
+    bool readable = false;  // the socket may hold data not read yet
+    bool queued = false;    // in the current or next tick's list of connections to serve
+    bool closing = false;
+};
+
+/**
+ * A request taken off a connection, waiting for the batch to be applied.
+ */
+struct Request {
+    int fd;
+    std::string payload;
+};
+
+struct Server {
+    std::vector<Dish*> menu;    // by row; nullptr if the row did not parse
+    std::mutex kitchen_mutex;
+    Kitchen kitchen;
+    int listen_fd = -1;
+};
+
+/**
+ * Reads an unsigned LEB128 varint.
+ * @return False if the input ends inside the varint or it does not fit 64 bits.
+ */
+bool readVarint(const std::string& payload, size_t& offset, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && offset < payload.size(); shift += 7) {
+        uint8_t byte = uint8_t(payload[offset++]);
+        value |= uint64_t(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void appendFrameHeader(std::string& output, const uint32_t& length) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        output.push_back(char((length >> shift) & 0xff));
+    }
+}
+
+Dish* menuDish(Server& server, const std::string& payload) {
+    size_t offset = 1;
+    uint64_t row;
+    if (!readVarint(payload, offset, row) || offset != payload.size() || row >= server.menu.size()) {
+        return nullptr;
+    }
+    return server.menu[row];
+}
+
+/**
+ * Applies one request; the caller holds the kitchen mutex.
+ * @param response Receives the status byte and the result.
+ */
+void apply(Server& server, const std::string& payload, std::string& response) {
+    SerialWriter writer(response);
+    if (payload.empty()) {
+        writer.byte(BAD_REQUEST);
+        return;
+    }
+    Kitchen& kitchen = server.kitchen;
+    size_t offset = 1;
+    uint64_t value;
+    switch (payload[0]) {
+        case ORDER:
+        case SERVE: {
+            Dish* dish = menuDish(server, payload);
+            if (dish == nullptr) {
+                writer.byte(BAD_REQUEST);
+            } else {
+                bool ok = payload[0] == ORDER ? kitchen.newOrder(dish) : kitchen.serveDish(dish);
+                writer.byte(ok ? OK : FAILED);
+            }
+            return;
+        }
+        case RELEASE_PREP:
+            if (!readVarint(payload, offset, value) || offset != payload.size() || value > 1000000) {
+                writer.byte(BAD_REQUEST);
+                return;
+            }
+            writer.byte(OK);
+            writer.varint(kitchen.releaseDishesBelowPrepTime(int(value)));
+            return;
+        case RELEASE_CUISINE:
+            writer.byte(OK);
+            writer.varint(kitchen.releaseDishesOfCuisineType(payload.substr(1)));
+            return;
+        case DIETARY: {
+            if (payload.size() != 2) {
+                writer.byte(BAD_REQUEST);
+                return;
+            }
+            uint8_t flags = uint8_t(payload[1]);
+            kitchen.dietaryAdjustment({ bool(flags & 1), bool(flags & 2), bool(flags & 4), bool(flags & 8),
+                bool(flags & 16), bool(flags & 32) });
+            writer.byte(OK);
+            return;
+        }
+        case REPORT: {
+            std::ostringstream text;
+            std::streambuf* cout_buffer = std::cout.rdbuf(text.rdbuf());
+            kitchen.kitchenReport();
+            std::cout.rdbuf(cout_buffer);
+            writer.byte(OK);
+            writer.text(text.str());
+            return;
+        }
+        case EXPORT:
+            if (payload.size() != 2 || uint8_t(payload[1]) > Serializable::BINARY) {
+                writer.byte(BAD_REQUEST);
+                return;
+            }
+            writer.byte(OK);
+            kitchen.serialize(Serializable::Format(payload[1]), response);
+            return;
+        default:
+            writer.byte(BAD_REQUEST);
+            return;
+    }
+}
+
+uint32_t frameLength(const std::string& input, const size_t& offset) {
+    const unsigned char* header = reinterpret_cast<const unsigned char*>(input.data() + offset);
+    return header[0] | header[1] << 8 | header[2] << 16 | uint32_t(header[3]) << 24;
+}
+
+/**
+ * @return Whether the input starts with a complete frame.
+ */
+bool frameReady(const std::string& input) {
+    return input.size() >= 4 && input.size() - 4 >= frameLength(input, 0);
+}
+
+/**
+ * Moves up to MAX_FRAMES_PER_TICK complete frames of a connection's input into the batch.
+ * @return False if a frame is larger than MAX_FRAME.
+ */
+bool takeFrames(const int& fd, Connection& connection, std::vector<Request>& batch) {
+    size_t offset = 0;
+    for (int taken = 0; taken < MAX_FRAMES_PER_TICK && connection.input.size() - offset >= 4; taken++) {
+        uint32_t length = frameLength(connection.input, offset);
+        if (length > MAX_FRAME) {
+            return false;
+        }
+        if (connection.input.size() - offset - 4 < length) {
+            break;
+        }
+        batch.push_back({ fd, connection.input.substr(offset + 4, length) });
+        offset += 4 + length;
+    }
+    connection.input.erase(0, offset);
+    return true;
+}
+
+/**
+ * Reads what the connection's input has room for and takes its frames into
+ * the batch, unless its pending output is above MAX_OUTPUT.
+ * @param chunk A READ_SIZE receive buffer.
+ */
+void takeRequests(const int& fd, Connection& connection, char* chunk, std::vector<Request>& batch) {
+    if (connection.output.size() > MAX_OUTPUT) {
+        return;
+    }
+    while (connection.readable && !connection.closing && connection.input.size() < MAX_INPUT) {
+        ssize_t received = ::recv(fd, chunk, std::min(READ_SIZE, MAX_INPUT - connection.input.size()), 0);
+        if (received > 0) {
+            connection.input.append(chunk, size_t(received));
+        } else if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            connection.readable = false;
+        } else {
+            connection.readable = false;
+            connection.closing = true;
+        }
+    }
+    if (!takeFrames(fd, connection, batch)) {
+        connection.input.clear();
+        connection.closing = true;
+    }
+}
+
+/**
+ * Writes as much pending output as the socket accepts.
+ * @return False if the connection failed.
+ */
+bool flush(const int& fd, Connection& connection) {
+    while (connection.output_sent < connection.output.size()) {
+        ssize_t sent = ::send(fd, connection.output.data() + connection.output_sent,
+            connection.output.size() - connection.output_sent, MSG_NOSIGNAL);
+        if (sent < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        connection.output_sent += size_t(sent);
+    }
+    connection.output.clear();
+    connection.output_sent = 0;
+    return true;
+}
+
+void closeConnection(const int& epoll_fd, std::unordered_map<int, Connection>& connections, const int& fd) {
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections.erase(fd);
+}
+
+void runLoop(Server& server) {
+    int epoll_fd = ::epoll_create1(0);
+    epoll_event listen_event = {};
+    listen_event.events = EPOLLIN | EPOLLEXCLUSIVE;
+    listen_event.data.fd = server.listen_fd;
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server.listen_fd, &listen_event);
+
+    std::unordered_map<int, Connection> connections;
+    std::vector<Request> batch;
+    std::vector<int> touched;
+    std::vector<int> backlog;    // connections with input left over from the last tick
+    std::string responses;
+    char chunk[READ_SIZE];
+    epoll_event events[MAX_EVENTS];
+    while (!stopping.load()) {
+        // edge-triggered: a connection with input left over gets no new event, so do not wait
+        int ready = ::epoll_wait(epoll_fd, events, MAX_EVENTS, backlog.empty() ? 200 : 0);
+        batch.clear();
+        touched.swap(backlog);
+        backlog.clear();
+        for (int e = 0; e < ready; e++) {
+            int fd = events[e].data.fd;
+            if (fd == server.listen_fd) {
+                int client = ::accept4(server.listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (client >= 0) {
+                    epoll_event client_event = {};
+                    client_event.events = EPOLLIN | EPOLLOUT | EPOLLET | EPOLLRDHUP;
+                    client_event.data.fd = client;
+                    ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client, &client_event);
+                    connections[client];
+                }
+                continue;
+            }
+            auto found = connections.find(fd);
+            if (found == connections.end()) {
+                continue;
+            }
+            Connection& connection = found->second;
+            if (events[e].events & EPOLLOUT && !flush(fd, connection)) {
+                connection.closing = true;
+            }
+            if (events[e].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                connection.readable = true;
+            }
+            if (!connection.queued) {
+                connection.queued = true;
+                touched.push_back(fd);
+            }
+        }
+        for (int fd : touched) {
+            takeRequests(fd, connections[fd], chunk, batch);
+        }
+
+        if (!batch.empty()) {
+            std::lock_guard<std::mutex> lock(server.kitchen_mutex);
+            for (const Request& request : batch) {
+                responses.clear();
+                apply(server, request.payload, responses);
+                std::string& output = connections[request.fd].output;
+                appendFrameHeader(output, uint32_t(responses.size()));
+                output.append(responses);
+            }
+        }
+
+        for (int fd : touched) {
+            Connection& connection = connections[fd];
+            connection.queued = false;
+            // a connection closed by its peer still gets the responses it asked for
+            bool has_input = (connection.readable && !connection.closing) || frameReady(connection.input);
+            if (!flush(fd, connection) || (connection.closing && connection.output.empty() && !has_input)) {
+                closeConnection(epoll_fd, connections, fd);
+            } else if (has_input && connection.output.size() <= MAX_OUTPUT) {
+                connection.queued = true;
+                backlog.push_back(fd);
+            }
+            // above MAX_OUTPUT, the EPOLLOUT once the client reads brings the connection back
+        }
+    }
+    while (!connections.empty()) {
+        closeConnection(epoll_fd, connections, connections.begin()->first);
+    }
+    ::close(epoll_fd);
+}
+
+bool loadMenu(const std::string& filename, std::vector<Dish*>& menu) {
+    std::ifstream file(filename);
+    std::string row;
+    if (!std::getline(file, row)) {
+        return false;
+    }
+    while (std::getline(file, row)) {
+        menu.push_back(DishCsv::parseRow(row));
+    }
+    return true;
+}
+
+int listenOn(const std::string& path) {
+    sockaddr_un address = {};
+    if (path.size() >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    ::unlink(path.c_str());
+    if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, 128) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: server <socket_path> <menu.csv> [threads]\n");
+        return 2;
+    }
+    int threads = argc > 3 ? std::atoi(argv[3]) : 1;
+    if (threads <= 0) {
+        std::fprintf(stderr, "server: threads must be positive\n");
+        return 2;
+    }
+    Server server;
+    if (!loadMenu(argv[2], server.menu)) {
+        std::fprintf(stderr, "server: could not read %s\n", argv[2]);
+        return 1;
+    }
+    server.listen_fd = listenOn(argv[1]);
+    if (server.listen_fd < 0) {
+        std::fprintf(stderr, "server: could not listen on %s: %s\n", argv[1], std::strerror(errno));
+        return 1;
+    }
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    std::vector<std::thread> loops;
+    for (int t = 0; t < threads; t++) {
+        loops.emplace_back(runLoop, std::ref(server));
+    }
+    for (std::thread& loop : loops) {
+        loop.join();
+    }
+    ::close(server.listen_fd);
+    ::unlink(argv[1]);
+
+    for (Dish* dish : server.menu) {
+        delete dish;
+    }
+    return 0;
+}